@@ -0,0 +1,129 @@
+/*
+ * Micro-benchmark dei kernel della distanza L1 (distanza_l1.h) su righe di punteggi Borda.
+ * Per ogni numero di progetti confronta tutte le famiglie di kernel eseguibili sulla CPU sullo stesso
+ * insieme di coppie di righe, verificando che diano la stessa somma della versione portabile. Come nel
+ * programma, le righe hanno il riempimento a zero e ogni kernel le legge fino a un multiplo del suo blocco.
+ *
+ * Compilazione, dalla cartella principale del progetto:
+ *   gcc -std=c89 -pedantic -Wall -O2 -I. -o bench_l1 bench/bench_distanza_l1.c distanza_l1.c
+ * Utilizzo:
+ *   ./bench_l1 [num_righe]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "distanza_l1.h"
+
+/* Righe generate per ogni misura: le coppie confrontate sono num_righe * (num_righe - 1) / 2 */
+#ifndef BENCH_RIGHE
+#define BENCH_RIGHE 2000
+#endif
+/* Passo delle righe, come nelle matrici del programma */
+#define BENCH_ALLINEAMENTO 64
+
+/**
+ * @brief Riempie una riga con i punteggi Borda di una preferenza casuale senza parita' (permutazione di 1..P).
+ * @param scores La riga, di num_projects elementi.
+ * @param num_projects Numero di progetti.
+ */
+static void random_borda_row(int *scores, int num_projects) {
+    int k;
+    for (k = 0; k < num_projects; ++k) {
+        scores[k] = k + 1;
+    }
+    for (k = num_projects - 1; k > 0; --k) {
+        int other = rand() % (k + 1);
+        int swap = scores[k];
+        scores[k] = scores[other];
+        scores[other] = swap;
+    }
+}
+
+/**
+ * @brief Somma le distanze di tutte le coppie di righe con un kernel, alla larghezza indicata.
+ * @param kernel La famiglia di kernel.
+ * @param rows Le righe, a passo 'stride' byte.
+ * @param stride Passo delle righe.
+ * @param width Byte per punteggio (1, 2 o 4).
+ * @param num_rows Numero di righe.
+ * @param num_projects Numero di progetti.
+ * @return La somma di tutte le distanze (per il confronto tra kernel).
+ */
+static double sum_all_pairs(const KernelDistanzaL1 *kernel, const unsigned char *rows, size_t stride, int width, int num_rows, int num_projects) {
+    double total = 0.0;
+    int i, j;
+    for (i = 0; i < num_rows; ++i) {
+        const unsigned char *row_i = rows + (size_t)i * stride;
+        for (j = i + 1; j < num_rows; ++j) {
+            const unsigned char *row_j = rows + (size_t)j * stride;
+            switch (width) {
+                case 1: total += kernel->u8(row_i, row_j, num_projects); break;
+                case 2: total += kernel->u16((const unsigned short *)row_i, (const unsigned short *)row_j, num_projects); break;
+                default: total += kernel->i32((const int *)row_i, (const int *)row_j, num_projects); break;
+            }
+        }
+    }
+    return total;
+}
+
+int main(int argc, char *argv[]) {
+    static const int project_counts[] = {10, 30, 64, 100, 200, 255, 300, 1000};
+    int num_rows = BENCH_RIGHE;
+    int num_sizes = (int)(sizeof(project_counts) / sizeof(project_counts[0]));
+    int s, i, k;
+
+    if (argc > 1) {
+        num_rows = atoi(argv[1]);
+        if (num_rows < 2) {
+            fprintf(stderr, "ERRORE: Servono almeno 2 righe.\n");
+            return EXIT_FAILURE;
+        }
+    }
+    srand(12345);
+    printf("Righe: %d (%ld coppie per misura)\n", num_rows, (long)num_rows * (num_rows - 1) / 2);
+    printf("%6s %5s %-10s %14s %10s\n", "P", "byte", "kernel", "ns/coppia", "speedup");
+
+    for (s = 0; s < num_sizes; ++s) {
+        int num_projects = project_counts[s];
+        int width = num_projects <= 255 ? 1 : 2;
+        size_t stride = ((size_t)num_projects * width + BENCH_ALLINEAMENTO - 1) / BENCH_ALLINEAMENTO * BENCH_ALLINEAMENTO;
+        unsigned char *rows = (unsigned char *)calloc((size_t)num_rows, stride);
+        int *scores = (int *)malloc(num_projects * sizeof(int));
+        double reference = 0.0, portable_time = 0.0;
+        if (!rows || !scores) {
+            fprintf(stderr, "ERRORE: Allocazione fallita.\n");
+            return EXIT_FAILURE;
+        }
+        for (i = 0; i < num_rows; ++i) {
+            random_borda_row(scores, num_projects);
+            for (k = 0; k < num_projects; ++k) {
+                if (width == 1) {
+                    rows[(size_t)i * stride + k] = (unsigned char)scores[k];
+                } else {
+                    ((unsigned short *)(rows + (size_t)i * stride))[k] = (unsigned short)scores[k];
+                }
+            }
+        }
+        printf("%6d %5d %-10s (scelto dal programma)\n", num_projects, width, select_l1_kernel((size_t)num_projects * width)->nome);
+        for (k = 0; k < count_l1_kernels(); ++k) {
+            const KernelDistanzaL1 *kernel = get_l1_kernel(k);
+            size_t length = ((size_t)num_projects * width + kernel->blocco - 1) / kernel->blocco * kernel->blocco;
+            clock_t start = clock();
+            double total = sum_all_pairs(kernel, rows, stride, width, num_rows, (int)((length < stride ? length : stride) / width));
+            double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+            double pairs = (double)num_rows * (num_rows - 1) / 2.0;
+            if (k == 0) {
+                reference = total;
+                portable_time = elapsed;
+            } else if (total != reference) {
+                fprintf(stderr, "ERRORE: Il kernel %s differisce dalla versione portabile (P = %d).\n", kernel->nome, num_projects);
+                return EXIT_FAILURE;
+            }
+            printf("%6d %5d %-10s %14.2f %9.2fx\n", num_projects, width, kernel->nome, elapsed * 1e9 / pairs,
+                   elapsed > 0.0 ? portable_time / elapsed : 0.0);
+        }
+        free(rows);
+        free(scores);
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,63 +1,469 @@
+/* Le funzioni POSIX (mmap) non sono visibili compilando in modalita' C89 stretta senza questa macro */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+/* madvise e MAP_ANONYMOUS (huge pages per le matrici) su glibc */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
 #include "data_manager.h"
 #include "sort.h"          
+#include "parallelo.h"
 /* Doxygen++; :) */
+
+/* Su sistemi POSIX il file viene mappato in memoria, altrimenti letto con un'unica fread */
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define DM_USA_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#define DM_USA_MMAP 0
+#endif
+
+/* Huge pages per le matrici solo dove il kernel accetta il suggerimento MADV_HUGEPAGE */
+#if DM_USA_MMAP && defined(MADV_HUGEPAGE) && defined(MAP_ANONYMOUS)
+#define DM_USA_PAGINE_GRANDI 1
+#else
+#define DM_USA_PAGINE_GRANDI 0
+#endif
+
+/* Impostato da use_huge_pages */
+static int matrici_pagine_grandi = 0;
+
+/**
+ * @brief Contenuto dell'intero file di input, mappato in memoria o letto in blocco.
+ * Il parser lavora direttamente su questo buffer, senza copie intermedie dei token.
+ */
+typedef struct {
+    char *dati;         /* Inizio del contenuto del file */
+    size_t dimensione;  /* Numero di byte validi */
+    int mappato;        /* 1 se ottenuto con mmap, 0 se allocato con malloc */
+} BufferDati;
+
+/**
+ * @brief Indice hash (indirizzamento aperto, scansione lineare) dai nomi dei progetti al loro indice alfabetico.
+ * Costruito una sola volta dopo l'ordinamento dei nomi: ogni token viene risolto in O(1) atteso.
+ */
+typedef struct {
+    int *slot;              /* Indice del progetto nello slot, -1 se vuoto */
+    unsigned long *hash;    /* Hash precalcolato del nome nello slot, evita memcmp inutili */
+    unsigned long maschera; /* Capacita' - 1 (la capacita' e' una potenza di 2) */
+    char **nomi;            /* Array ordinato dei nomi, per il confronto finale */
+} IndiceProgetti;
+
+/**
+ * @brief Intestazione del formato binario. Seguono, senza separatori:
+ * - num_progetti nomi ordinati alfabeticamente, ciascuno di PROG_LENGTH + 1 byte;
+ * - num_abitanti codici fiscali, ciascuno di CF_LENGTH + 1 byte;
+ * - num_abitanti x num_progetti indici dei progetti, gia' risolti in ordine alfabetico, alla
+ *   larghezza larghezza_ranking (la stessa dell'archivio in memoria);
+ * - num_abitanti x (num_progetti - 1) simboli di preferenza ('<' o '=').
+ * Gli interi sono nell'ordine di byte della macchina che ha scritto il file: il campo
+ * controllo_ordine permette di rifiutare file prodotti su architetture diverse.
+ */
+typedef struct {
+    char firma[4];          /* BINARIO_FIRMA, senza terminatore */
+    int versione;           /* BINARIO_VERSIONE */
+    int controllo_ordine;   /* 0x01020304 scritto in ordine nativo */
+    int dimensione_int;     /* sizeof(int) al momento della scrittura */
+    int lunghezza_progetto; /* PROG_LENGTH */
+    int lunghezza_cf;       /* CF_LENGTH */
+    int num_abitanti;
+    int num_progetti;
+    int num_gruppi;
+    int larghezza_ranking;  /* Byte per indice di progetto (select_rank_width) */
+} IntestazioneBinaria;
+
+#define BINARIO_CONTROLLO_ORDINE 0x01020304
+
+/**
+ * @brief Inizio delle sezioni del formato binario all'interno del file mappato.
+ */
+typedef struct {
+    const char *nomi;    /* Tabella ordinata dei nomi dei progetti */
+    const char *cf;      /* Codici fiscali a lunghezza fissa */
+    const char *indici;  /* Indici dei progetti per cittadino */
+    const char *simboli; /* Simboli di preferenza per cittadino */
+} SezioniBinarie;
+
+/**
+ * @brief Dati condivisi dai thread del parser: la sezione cittadini e' divisa in blocchi
+ * che iniziano e finiscono a inizio riga (una riga per cittadino).
+ */
+typedef struct {
+    const char **confini;     /* num_blocchi + 1 confini, il blocco w e' [confini[w], confini[w + 1]) */
+    int *righe_blocco;        /* Righe cittadino (non vuote) di ciascun blocco */
+    int *primo_cittadino;     /* Indice globale del primo cittadino di ciascun blocco */
+    int *errore_blocco;       /* Prima riga cittadino non valida di ciascun blocco (da 1), 0 se nessuna */
+    ArchivioCittadini *citizens;
+    const IndiceProgetti *index;
+} LavoroParser;
+
+/**
+ * @brief Stato della lettura sequenziale di un file di input, un cittadino alla volta.
+ * Il cittadino corrente e' l'unica struttura per-cittadino allocata: viene sovrascritto a ogni lettura.
+ */
+struct FlussoCittadini {
+    BufferDati buffer;
+    int binario;            /* 1 per il formato binario, 0 per quello testuale */
+    SezioniBinarie sezioni; /* Solo formato binario */
+    IndiceProgetti indice;  /* Solo formato testuale */
+    const char *cursore;    /* Solo formato testuale: prossima riga cittadino */
+    int num_abitanti;
+    int num_progetti;
+    int letti;              /* Cittadini gia' restituiti */
+    ArchivioCittadini corrente; /* Archivio di un solo cittadino, riusato a ogni lettura */
+};
+
+/**
+ * @brief Stato della lettura incrementale di un file testuale a cui vengono aggiunte righe.
+ * Il file resta aperto: ogni lettura riprende dall'ultimo byte letto, quindi il costo dipende solo dalle righe nuove.
+ */
+struct CodaCittadini {
+    FILE *fp;
+    char *dati;             /* Byte letti ma non ancora consumati (al piu' una riga incompleta oltre alle complete) */
+    size_t inizio;          /* Primo byte non consumato */
+    size_t fine;            /* Byte validi in dati */
+    size_t capacita;
+    IndiceProgetti indice;
+    int num_abitanti;
+    int num_progetti;
+    int letti;              /* Cittadini gia' restituiti */
+    ArchivioCittadini corrente; /* Archivio di un solo cittadino, riusato a ogni lettura */
+};
+
+/* Byte letti dal file a ogni tentativo della lettura incrementale */
+#define CODA_BLOCCO_LETTURA 65536
+
 /* === Sezione di Gestione Iniziale Dati e Allocazione === */
 /* Funzioni ausiliarie per la gestione dei dati iniziali */
-static FILE *attempt_file_open(const char *path_to_file);
-static void read_initial_params(FILE *fp, ParametriInput *params);
-static cittadino **allocate_citizen_array(int count);
+static void map_data_file(const char *path_to_file, BufferDati *buffer);
+static void unmap_data_file(BufferDati *buffer);
+static const char *next_token(const char **cursor, const char *end, size_t *length);
+static const char *parse_int_token(const char *cursor, const char *end, int *value);
+static const char *read_initial_params(const BufferDati *buffer, ParametriInput *params);
+static void check_group_count(int num_groups);
+static void set_citizen_rank(cittadino *citizen, int pos, int rank);
+static void allocate_citizen_store(ArchivioCittadini *store, int num_citizens, int num_projects);
 static char **allocate_project_names_array(int count);
-static void load_project_names(FILE *fp, int num_progetti, char **project_names);
-static int find_project_index_binary(char **project_list, int low, int high, const char *target_name);
-static void populate_citizen_data(FILE *fp, cittadino **citizens, int num_citizens, int num_projects, char **project_names);
-static void close_data_file(FILE *fp);
+static void load_project_names(const char *cursor, const char *end, int num_progetti, char **project_names);
+static unsigned long hash_project_name(const char *name, size_t length);
+static void build_project_index(IndiceProgetti *index, char **project_names, int num_projects);
+static int find_project_index_hash(const IndiceProgetti *index, const char *target_name, size_t target_length);
+static void free_project_index(IndiceProgetti *index);
+static const char *parse_citizen_record(const char *cursor, const char *end, cittadino *citizen, int num_projects, const IndiceProgetti *index);
+static void populate_citizen_data(const char *cursor, const char *end, ArchivioCittadini *citizens, const IndiceProgetti *index);
+static int is_blank_line(const char *line, const char *line_end);
+static const char *find_line_end(const char *line, const char *end);
+static const char *next_citizen_line(const char **cursor, const char *end, const char **line_end);
+static int parse_citizen_line(const char *line, const char *line_end, cittadino *citizen, int num_projects, const IndiceProgetti *index);
+static void count_chunk_records(void *context, int worker, int num_workers);
+static void parse_chunk_records(void *context, int worker, int num_workers);
+static void populate_citizen_data_parallel(const char *cursor, const char *end, ArchivioCittadini *citizens, const IndiceProgetti *index, int num_workers);
+static int is_binary_data(const BufferDati *buffer);
+static void read_binary_layout(const BufferDati *buffer, ParametriInput *params, SezioniBinarie *sections);
+static void load_binary_projects(const SezioniBinarie *sections, int num_projects, char **projects);
+static void copy_binary_citizen(const SezioniBinarie *sections, int c_idx, int num_projects, cittadino *citizen);
+static void load_binary_data(const BufferDati *buffer, ParametriInput *params, ArchivioCittadini *citizens, char ***projects);
+static const char *prepare_text_data(const BufferDati *buffer, ParametriInput *params, char ***projects, IndiceProgetti *index);
+static size_t read_tail_bytes(CodaCittadini *tail);
 
 /**
- * @brief Tenta l'apertura di un file in modalit lettura.
+ * @brief Mappa in memoria (sola lettura) l'intero file di input.
+ * Dove mmap non e' disponibile il file viene letto con una singola fread in un buffer allocato.
  * @param path_to_file Percorso del file da aprire.
- * @return Puntatore al FILE aperto. Esci con errore se l'apertura fallisce.
+ * @param buffer Struttura da riempire con indirizzo e dimensione del contenuto. Esce con errore se l'apertura fallisce.
  */
-static FILE *attempt_file_open(const char *path_to_file) {
-    FILE *fp = fopen(path_to_file, "r");
+static void map_data_file(const char *path_to_file, BufferDati *buffer) {
+#if DM_USA_MMAP
+    struct stat info;
+    int fd = open(path_to_file, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "ERRORE: Impossibile aprire il file '%s'. Controllare percorso o permessi.\n", path_to_file);
+        exit(EXIT_FAILURE);
+    }
+    if (fstat(fd, &info) != 0) {
+        fprintf(stderr, "ERRORE: Impossibile determinare la dimensione del file '%s'.\n", path_to_file);
+        exit(EXIT_FAILURE);
+    }
+    buffer->dimensione = (size_t)info.st_size;
+    buffer->dati = NULL;
+    buffer->mappato = 0;
+    if (buffer->dimensione > 0) {
+        void *indirizzo = mmap(NULL, buffer->dimensione, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (indirizzo == MAP_FAILED) {
+            fprintf(stderr, "ERRORE: Impossibile mappare in memoria il file '%s'.\n", path_to_file);
+            exit(EXIT_FAILURE);
+        }
+        posix_madvise(indirizzo, buffer->dimensione, POSIX_MADV_SEQUENTIAL); /* Lettura lineare: il kernel puo' anticipare le pagine */
+        buffer->dati = (char *)indirizzo;
+        buffer->mappato = 1;
+    }
+    close(fd); /* La mappatura resta valida anche dopo la chiusura del descrittore */
+#else
+    long lunghezza;
+    FILE *fp = fopen(path_to_file, "rb");
     if (!fp) {
         fprintf(stderr, "ERRORE: Impossibile aprire il file '%s'. Controllare percorso o permessi.\n", path_to_file);
         exit(EXIT_FAILURE);
     }
-    return fp;
+    fseek(fp, 0, SEEK_END);
+    lunghezza = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (lunghezza < 0) {
+        fprintf(stderr, "ERRORE: Impossibile determinare la dimensione del file '%s'.\n", path_to_file);
+        exit(EXIT_FAILURE);
+    }
+    buffer->dimensione = (size_t)lunghezza;
+    buffer->mappato = 0;
+    buffer->dati = (char *)malloc(buffer->dimensione + 1);
+    if (!buffer->dati) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il buffer del file di input.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (fread(buffer->dati, 1, buffer->dimensione, fp) != buffer->dimensione) {
+        fprintf(stderr, "ERRORE: Lettura incompleta del file '%s'.\n", path_to_file);
+        exit(EXIT_FAILURE);
+    }
+    fclose(fp);
+#endif
+}
+
+/**
+ * @brief Rilascia il contenuto del file ottenuto con map_data_file.
+ * @param buffer Il buffer da rilasciare.
+ */
+static void unmap_data_file(BufferDati *buffer) {
+#if DM_USA_MMAP
+    if (buffer->mappato) {
+        munmap(buffer->dati, buffer->dimensione);
+    }
+#else
+    free(buffer->dati);
+#endif
+    buffer->dati = NULL;
+    buffer->dimensione = 0;
+}
+
+/**
+ * @brief Individua il prossimo token (sequenza di caratteri non spaziatori) nel buffer, senza copiarlo.
+ * @param cursor Posizione corrente, aggiornata al primo carattere dopo il token.
+ * @param end Fine del buffer.
+ * @param length Lunghezza del token trovato.
+ * @return Puntatore all'inizio del token, NULL se il buffer e' terminato.
+ */
+static const char *next_token(const char **cursor, const char *end, size_t *length) {
+    const char *p = *cursor;
+    const char *start;
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')) {
+        p++;
+    }
+    if (p == end) {
+        *cursor = p;
+        return NULL;
+    }
+    start = p;
+    while (p < end && !(*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')) {
+        p++;
+    }
+    *length = (size_t)(p - start);
+    *cursor = p;
+    return start;
+}
+
+/**
+ * @brief Converte il prossimo token in un intero (equivalente a "%d" di scanf).
+ * @param cursor Posizione corrente nel buffer.
+ * @param end Fine del buffer.
+ * @param value Dove memorizzare il valore letto.
+ * @return La posizione successiva al numero, NULL se il token non e' un intero.
+ */
+static const char *parse_int_token(const char *cursor, const char *end, int *value) {
+    size_t length, i = 0;
+    int negative = 0, result = 0;
+    const char *token = next_token(&cursor, end, &length);
+    if (!token) {
+        return NULL;
+    }
+    if (token[0] == '-' || token[0] == '+') {
+        negative = (token[0] == '-');
+        i = 1;
+    }
+    if (i == length) {
+        return NULL;
+    }
+    for (; i < length; ++i) {
+        if (token[i] < '0' || token[i] > '9') {
+            return NULL;
+        }
+        result = result * 10 + (token[i] - '0');
+    }
+    *value = negative ? -result : result;
+    return cursor;
+}
+
+/**
+ * @brief Rifiuta un numero di gruppi minore di 1: il clustering ne forma sempre almeno uno.
+ * @param num_groups Il numero di gruppi letto dall'intestazione.
+ */
+static void check_group_count(int num_groups) {
+    if (num_groups < 1) {
+        fprintf(stderr, "ERRORE: Numero di gruppi non valido (%d): deve essere almeno 1.\n", num_groups);
+        exit(EXIT_FAILURE);
+    }
 }
 
 /**
  * @brief Legge i parametri fondamentali (numero abitanti, progetti, gruppi) dal file.
- * @param fp Il file stream.
+ * @param buffer Il contenuto del file.
  * @param params Puntatore alla struttura dove memorizzare i parametri letti.
+ * @return La posizione nel buffer subito dopo i parametri.
  */
-static void read_initial_params(FILE *fp, ParametriInput *params) {
-    if (fscanf(fp, "%d %d %d", &params->num_abitanti, &params->num_progetti, &params->num_gruppi) != NUM_PARAM_INIZIALI) {
+static const char *read_initial_params(const BufferDati *buffer, ParametriInput *params) {
+    const char *cursor = buffer->dati;
+    const char *end = buffer->dati + buffer->dimensione;
+    if (!(cursor = parse_int_token(cursor, end, &params->num_abitanti)) ||
+        !(cursor = parse_int_token(cursor, end, &params->num_progetti)) ||
+        !(cursor = parse_int_token(cursor, end, &params->num_gruppi))) {
         fprintf(stderr, "ERRORE: Formato dati iniziale non valido. Attesi %d parametri.\n", NUM_PARAM_INIZIALI);
         exit(EXIT_FAILURE);
     }
+    check_group_count(params->num_gruppi);
+    return cursor;
 }
 
 /**
- * @brief Alloca memoria per un array di puntatori a strutture 'cittadino'.
- * @param count Il numero di cittadini da allocare.
- * @return Array di puntatori a 'cittadino' allocato e inizializzato.
+ * @brief Sceglie la larghezza minima degli indici di progetto e dei punteggi Borda.
+ * Gli indici vanno da 0 a num_projects - 1 e i punteggi Borda da 0 a num_projects.
+ * @param num_projects Il numero di progetti.
+ * @return 1 (unsigned char), 2 (unsigned short) o 4 (int) byte per elemento.
  */
-static cittadino **allocate_citizen_array(int count) {
-	int i;
-    cittadino **citizens = (cittadino **)calloc(count, sizeof(cittadino *));
-    if (!citizens) {
-        fprintf(stderr, "ERRORE: Allocazione fallita per l'array principale dei cittadini.\n");
+int select_rank_width(int num_projects) {
+    if (num_projects <= UCHAR_MAX) {
+        return 1;
+    }
+    if (num_projects <= USHRT_MAX) {
+        return 2;
+    }
+    return (int)sizeof(int);
+}
+
+/**
+ * @brief Legge l'indice di progetto in una posizione del ranking di un cittadino.
+ * @param citizen Il cittadino.
+ * @param pos La posizione nel ranking (0 = preferito).
+ * @return L'indice alfabetico del progetto.
+ */
+int get_citizen_rank(const cittadino *citizen, int pos) {
+    switch (citizen->larghezza) {
+        case 1: return citizen->progs.u8[pos];
+        case 2: return citizen->progs.u16[pos];
+        default: return citizen->progs.i32[pos];
+    }
+}
+
+/**
+ * @brief Scrive l'indice di progetto in una posizione del ranking di un cittadino.
+ * @param citizen Il cittadino.
+ * @param pos La posizione nel ranking.
+ * @param rank L'indice alfabetico del progetto (compreso tra 0 e num_progetti - 1).
+ */
+static void set_citizen_rank(cittadino *citizen, int pos, int rank) {
+    switch (citizen->larghezza) {
+        case 1: citizen->progs.u8[pos] = (unsigned char)rank; break;
+        case 2: citizen->progs.u16[pos] = (unsigned short)rank; break;
+        default: citizen->progs.i32[pos] = rank; break;
+    }
+}
+
+/**
+ * @brief Alloca l'archivio contiguo dei cittadini con un'unica calloc.
+ * Il blocco contiene, nell'ordine: i puntatori alle viste, le viste, la matrice dei ranking,
+ * la tabella dei codici fiscali e la matrice dei simboli; le viste vengono collegate subito alle loro righe.
+ * @param store L'archivio da inizializzare.
+ * @param num_citizens Il numero di cittadini.
+ * @param num_projects Il numero di progetti.
+ */
+static void allocate_citizen_store(ArchivioCittadini *store, int num_citizens, int num_projects) {
+    size_t count = (size_t)(num_citizens > 0 ? num_citizens : 0);
+    size_t pref_stride = (size_t)(num_projects > 1 ? num_projects - 1 : 0);
+    size_t list_bytes = count * sizeof(cittadino *);
+    size_t view_bytes = count * sizeof(cittadino);
+    int width = select_rank_width(num_projects);
+    size_t rank_bytes = count * (size_t)num_projects * width;
+    size_t cf_bytes = count * (CF_LENGTH + 1);
+    size_t pref_bytes = count * pref_stride + 1; /* +1: terminatore dopo l'ultima riga */
+    char *block;
+    size_t i;
+
+    /* Blocchi in ordine di allineamento decrescente: puntatori, strutture, indici, char */
+    if (count > 0 && (size_t)num_projects > ((size_t)-1 / sizeof(int)) / count) {
+        fprintf(stderr, "ERRORE: Archivio dei cittadini troppo grande (%d cittadini, %d progetti).\n", num_citizens, num_projects);
+        exit(EXIT_FAILURE);
+    }
+    block = (char *)calloc(list_bytes + view_bytes + rank_bytes + cf_bytes + pref_bytes, 1);
+    if (!block) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per l'archivio dei cittadini.\n");
+        exit(EXIT_FAILURE);
+    }
+    store->arena = block;
+    store->num_cittadini = (int)count;
+    store->num_progetti = num_projects;
+    store->larghezza = width;
+    store->elenco = (cittadino **)block;
+    store->viste = (cittadino *)(block + list_bytes);
+    store->ranking = block + list_bytes + view_bytes;
+    store->codici = block + list_bytes + view_bytes + rank_bytes;
+    store->simboli = store->codici + cf_bytes;
+
+    for (i = 0; i < count; ++i) {
+        store->viste[i].CF = store->codici + i * (CF_LENGTH + 1);
+        store->viste[i].progs.dati = (char *)store->ranking + i * (size_t)num_projects * width;
+        store->viste[i].larghezza = width;
+        store->viste[i].pref = store->simboli + i * pref_stride;
+        store->elenco[i] = &store->viste[i];
+    }
+}
+
+/**
+ * @brief Confronto tra due codici fiscali per qsort, dati i puntatori alle loro righe nella tabella dei codici.
+ * @param first Puntatore al primo codice.
+ * @param second Puntatore al secondo codice.
+ * @return Come strcmp.
+ */
+static int compare_citizen_codes(const void *first, const void *second) {
+    return strcmp(*(const char *const *)first, *(const char *const *)second);
+}
+
+/**
+ * @brief Ordina una volta i codici fiscali e assegna a ogni cittadino il rango denso del suo codice (0 al minore;
+ * codici uguali hanno lo stesso rango). Confrontare i ranghi da' lo stesso esito di strcmp sui codici, quindi
+ * le regole di parita' del clustering e del suo ordinamento possono confrontare interi.
+ * @param citizens L'archivio, gia' caricato.
+ */
+void rank_citizen_codes(ArchivioCittadini *citizens) {
+    int count = citizens->num_cittadini;
+    const char **codes = (const char **)malloc((count > 0 ? count : 1) * sizeof(const char *));
+    int i, rank = 0;
+    if (!codes) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per l'ordinamento dei codici fiscali.\n");
         exit(EXIT_FAILURE);
     }
     for (i = 0; i < count; ++i) {
-        citizens[i] = (cittadino *)calloc(1, sizeof(cittadino));
-        if (!citizens[i]) {
-            fprintf(stderr, "ERRORE: Allocazione fallita per un singolo cittadino all'indice %d.\n", i);
-            exit(EXIT_FAILURE);
+        codes[i] = citizens->viste[i].CF;
+    }
+    qsort((void *)codes, (size_t)count, sizeof(const char *), compare_citizen_codes);
+    for (i = 0; i < count; ++i) {
+        if (i > 0 && strcmp(codes[i], codes[i - 1]) != 0) {
+            rank++;
         }
+        /* La riga nella tabella dei codici e' l'indice del cittadino */
+        citizens->viste[(codes[i] - citizens->codici) / (CF_LENGTH + 1)].rango_cf = rank;
     }
-    return citizens;
+    free((void *)codes);
 }
 
 /**
@@ -84,120 +490,889 @@ static char **allocate_project_names_array(int count) {
 
 /**
  * @brief Carica i nomi dei progetti dal file e li inserisce nell'array.
- * @param fp Il file stream.
+ * I nomi sono quelli della prima riga cittadino: si saltano il codice fiscale e i simboli di preferenza.
+ * @param cursor Posizione nel buffer subito dopo i parametri iniziali.
+ * @param end Fine del buffer.
  * @param num_progetti Il numero totale di progetti da leggere.
  * @param project_names L'array di stringhe dove verranno memorizzati i nomi.
  */
-static void load_project_names(FILE *fp, int num_progetti, char **project_names) {
-    /* Salta la prima stringa e legge il primo nome del progetto */
+static void load_project_names(const char *cursor, const char *end, int num_progetti, char **project_names) {
     int i;
-    if (fscanf(fp, "%*s %s", project_names[0]) != 1) {
-        fprintf(stderr, "ERRORE: Impossibile leggere il primo nome del progetto.\n");
+    size_t length;
+    const char *token;
+    for (i = 0; i < num_progetti; ++i) {
+        /* Salta l'etichetta (codice fiscale o simbolo di preferenza) e legge il nome */
+        if (!next_token(&cursor, end, &length) || !(token = next_token(&cursor, end, &length)) || length > PROG_LENGTH) {
+            fprintf(stderr, "ERRORE: Impossibile leggere il nome del progetto all'indice %d.\n", i);
+            exit(EXIT_FAILURE);
+        }
+        memcpy(project_names[i], token, length);
+        project_names[i][length] = '\0';
+    }
+}
+
+/**
+ * @brief Calcola l'hash FNV-1a (32 bit) di un nome di progetto.
+ * @param name Puntatore al nome (non necessariamente terminato da '\0').
+ * @param length Lunghezza del nome.
+ * @return Il valore hash.
+ */
+static unsigned long hash_project_name(const char *name, size_t length) {
+    unsigned long h = 2166136261UL;
+    size_t i;
+    for (i = 0; i < length; ++i) {
+        h ^= (unsigned char)name[i];
+        h = (h * 16777619UL) & 0xFFFFFFFFUL; /* unsigned long puo' essere piu' largo di 32 bit */
+    }
+    return h;
+}
+
+/**
+ * @brief Costruisce l'indice hash dei progetti, da chiamare dopo l'ordinamento alfabetico dei nomi.
+ * Gli indici memorizzati sono le posizioni nell'array ordinato, come restituite dalla vecchia ricerca binaria.
+ * @param index L'indice da costruire.
+ * @param project_names L'array ordinato dei nomi dei progetti.
+ * @param num_projects Il numero di progetti.
+ */
+static void build_project_index(IndiceProgetti *index, char **project_names, int num_projects) {
+    unsigned long capacity = 16, pos;
+    int i;
+    while (capacity < 2UL * (unsigned long)num_projects) { /* Fattore di carico <= 0.5 */
+        capacity <<= 1;
+    }
+    index->maschera = capacity - 1;
+    index->nomi = project_names;
+    index->slot = (int *)malloc(capacity * sizeof(int));
+    index->hash = (unsigned long *)malloc(capacity * sizeof(unsigned long));
+    if (!index->slot || !index->hash) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per l'indice hash dei progetti.\n");
         exit(EXIT_FAILURE);
     }
-    for (i = 1; i < num_progetti; ++i) {
-        /* Salta l'etichetta del progetto e legge il nome */
-        if (fscanf(fp, "%*s %s", project_names[i]) != 1) {
-            fprintf(stderr, "ERRORE: Impossibile leggere il nome del progetto all'indice %d.\n", i);
+    for (pos = 0; pos < capacity; ++pos) {
+        index->slot[pos] = -1;
+    }
+    for (i = 0; i < num_projects; ++i) {
+        size_t length = strlen(project_names[i]);
+        unsigned long h = hash_project_name(project_names[i], length);
+        if (find_project_index_hash(index, project_names[i], length) >= 0) {
+            fprintf(stderr, "ERRORE: Errore nell'inserimento del progetto: nome non valido o duplicato (%s).\n", project_names[i]);
             exit(EXIT_FAILURE);
         }
+        for (pos = h & index->maschera; index->slot[pos] != -1; pos = (pos + 1) & index->maschera);
+        index->slot[pos] = i;
+        index->hash[pos] = h;
     }
 }
 
 /**
- * @brief Esegue una ricerca binaria per trovare l'indice di un progetto nell'array ordinato.
- * @param project_list L'array ordinato dei nomi dei progetti.
- * @param low L'indice di partenza per la ricerca.
- * @param high L'indice finale per la ricerca.
- * @param target_name La stringa con il nome del progetto da cercare.
+ * @brief Risolve un nome di progetto nel suo indice alfabetico tramite l'indice hash.
+ * @param index L'indice hash dei progetti.
+ * @param target_name Puntatore al nome del progetto da cercare (direttamente nel buffer del file).
+ * @param target_length Lunghezza del nome cercato.
  * @return L'indice del progetto se trovato, altrimenti -1.
  */
-static int find_project_index_binary(char **project_list, int low, int high, const char *target_name) {
-    while (low <= high) {
-        int mid = low + (high - low) / 2; /* Previene overflow rispetto a (low+high)/2 */
-        int cmp_result = strcmp(target_name, project_list[mid]);
-
-        if (cmp_result == 0) {
-            return mid; /* Progetto trovato */
-        } else if (cmp_result > 0) {
-            low = mid + 1; 
-        } else {
-            high = mid - 1; 
+static int find_project_index_hash(const IndiceProgetti *index, const char *target_name, size_t target_length) {
+    unsigned long h = hash_project_name(target_name, target_length);
+    unsigned long pos;
+    for (pos = h & index->maschera; index->slot[pos] != -1; pos = (pos + 1) & index->maschera) {
+        const char *candidate = index->nomi[index->slot[pos]];
+        if (index->hash[pos] == h && memcmp(candidate, target_name, target_length) == 0 && candidate[target_length] == '\0') {
+            return index->slot[pos]; /* Progetto trovato */
         }
     }
     return -1; /* Progetto non trovato*/
 }
 
+/**
+ * @brief Libera la memoria dell'indice hash dei progetti (i nomi restano di proprieta' del chiamante).
+ * @param index L'indice da liberare.
+ */
+static void free_project_index(IndiceProgetti *index) {
+    free(index->slot);
+    free(index->hash);
+    index->slot = NULL;
+    index->hash = NULL;
+}
+
+/**
+ * @brief Legge una riga cittadino: codice fiscale, primo progetto e coppie (simbolo, progetto).
+ * Come " %c %s" di scanf, il simbolo di preferenza e' il primo carattere non spaziatore.
+ * @param cursor Posizione corrente nel buffer.
+ * @param end Fine del buffer.
+ * @param citizen Il cittadino da popolare (progs e pref gia' allocati).
+ * @param num_projects Il numero totale di progetti.
+ * @param index L'indice hash dei nomi dei progetti per la lookup.
+ * @return La posizione successiva alla riga letta, NULL se la riga non e' valida.
+ */
+static const char *parse_citizen_record(const char *cursor, const char *end, cittadino *citizen, int num_projects, const IndiceProgetti *index) {
+    size_t length;
+    int p_idx, rank;
+    const char *token = next_token(&cursor, end, &length);
+    if (!token || length > CF_LENGTH) {
+        return NULL;
+    }
+    memcpy(citizen->CF, token, length);
+    citizen->CF[length] = '\0';
+
+    for (p_idx = 0; p_idx < num_projects; ++p_idx) {
+        if (p_idx > 0) {
+            /* Simbolo di preferenza tra il progetto precedente e il corrente */
+            while (cursor < end && (*cursor == ' ' || *cursor == '\n' || *cursor == '\t' || *cursor == '\r' || *cursor == '\v' || *cursor == '\f')) {
+                cursor++;
+            }
+            if (cursor == end) {
+                return NULL;
+            }
+            citizen->pref[p_idx - 1] = *cursor++;
+        }
+        token = next_token(&cursor, end, &length);
+        if (!token || length > PROG_LENGTH) {
+            return NULL;
+        }
+        rank = find_project_index_hash(index, token, length);
+        if (rank < 0) {
+            return NULL;
+        }
+        set_citizen_rank(citizen, p_idx, rank);
+    }
+    return cursor;
+}
+
 /**
  * @brief Popola le strutture dei cittadini con i loro codici e le preferenze sui progetti.
- * @param fp Il file stream.
- * @param citizens L'array di strutture cittadino da popolare.
- * @param num_citizens Il numero totale di cittadini.
+ * Un cittadino per riga (le righe vuote si saltano), con la stessa regola del parser parallelo.
+ * @param cursor Inizio della sezione cittadini nel buffer (la riga successiva ai parametri).
+ * @param end Fine del buffer.
+ * @param citizens L'archivio (gia' allocato) da popolare.
+ * @param index L'indice hash dei nomi dei progetti per la lookup.
+ */
+static void populate_citizen_data(const char *cursor, const char *end, ArchivioCittadini *citizens, const IndiceProgetti *index) {
+    const char *line, *line_end;
+    int c_idx;
+
+    for (c_idx = 0; c_idx < citizens->num_cittadini; ++c_idx) {
+        /* Tokenizza la riga direttamente nel buffer del file, scrivendo nelle righe dell'archivio */
+        line = next_citizen_line(&cursor, end, &line_end);
+        if (!line || !parse_citizen_line(line, line_end, &citizens->viste[c_idx], citizens->num_progetti, index)) {
+            fprintf(stderr, "ERRORE: Errore nel formato della riga cittadino %d: codice fiscale o preferenze non validi.\n", c_idx + 1);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * @brief Verifica se una riga contiene solo caratteri spaziatori.
+ * @param line Inizio della riga.
+ * @param line_end Fine della riga (il '\n' o la fine del buffer).
+ * @return 1 se la riga e' vuota, 0 altrimenti.
+ */
+static int is_blank_line(const char *line, const char *line_end) {
+    for (; line < line_end; ++line) {
+        if (!(*line == ' ' || *line == '\t' || *line == '\r' || *line == '\v' || *line == '\f')) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Trova la fine della riga che inizia in 'line'.
+ * @param line Inizio della riga.
+ * @param end Fine del buffer.
+ * @return Puntatore al '\n' che chiude la riga, oppure 'end'.
+ */
+static const char *find_line_end(const char *line, const char *end) {
+    const char *newline = (const char *)memchr(line, '\n', (size_t)(end - line));
+    return newline ? newline : end;
+}
+
+/**
+ * @brief Salta le righe vuote e restituisce la prossima riga cittadino, spostando il cursore oltre di essa.
+ * @param cursor Posizione corrente nel buffer (inizio di una riga), aggiornata.
+ * @param end Fine del buffer.
+ * @param line_end Dove memorizzare la fine della riga restituita.
+ * @return L'inizio della riga, NULL se il buffer e' finito.
+ */
+static const char *next_citizen_line(const char **cursor, const char *end, const char **line_end) {
+    const char *line;
+    while (*cursor < end) {
+        line = *cursor;
+        *line_end = find_line_end(line, end);
+        *cursor = (*line_end < end) ? *line_end + 1 : end;
+        if (!is_blank_line(line, *line_end)) {
+            return line;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Legge una riga cittadino intera: dopo l'ultimo progetto sono ammessi solo spaziatori.
+ * E' la regola di tutti i lettori del formato testuale (sequenziale, parallelo, -s e -f), quindi
+ * un file viene accettato o rifiutato allo stesso modo qualunque sia il numero di thread.
+ * @param line Inizio della riga.
+ * @param line_end Fine della riga (il '\n' o la fine del buffer).
+ * @param citizen Il cittadino da popolare (progs e pref gia' allocati).
  * @param num_projects Il numero totale di progetti.
- * @param project_names L'array ordinato dei nomi dei progetti per la lookup.
+ * @param index L'indice hash dei nomi dei progetti per la lookup.
+ * @return 1 se la riga e' valida, 0 altrimenti.
  */
-static void populate_citizen_data(FILE *fp, cittadino **citizens, int num_citizens, int num_projects, char **project_names) {
-    char project_buffer[PROG_LENGTH + 1];
-    int c, c_idx, p_idx;
-    /* Move the file pointer to the beginning of the file, first line already read once to create projs array, this does not consume extra memory */
-    fseek(fp, 0, SEEK_SET);
-    fscanf(fp, "%*[^\n]");
+static int parse_citizen_line(const char *line, const char *line_end, cittadino *citizen, int num_projects, const IndiceProgetti *index) {
+    const char *after = parse_citizen_record(line, line_end, citizen, num_projects, index);
+    return after != NULL && is_blank_line(after, line_end);
+}
+
+/**
+ * @brief Primo passo del parser parallelo: conta le righe cittadino del blocco assegnato al thread.
+ * @param context Il LavoroParser condiviso.
+ * @param worker Indice del blocco.
+ * @param num_workers Numero totale di blocchi.
+ */
+static void count_chunk_records(void *context, int worker, int num_workers) {
+    LavoroParser *job = (LavoroParser *)context;
+    const char *line = job->confini[worker];
+    const char *chunk_end = job->confini[worker + 1];
+    int count = 0;
+    (void)num_workers;
+    while (line < chunk_end) {
+        const char *line_end = find_line_end(line, chunk_end);
+        if (!is_blank_line(line, line_end)) {
+            count++;
+        }
+        line = line_end + 1;
+    }
+    job->righe_blocco[worker] = count;
+}
 
-    while ((c = fgetc(fp)) != '\n' && c != EOF);
+/**
+ * @brief Secondo passo del parser parallelo: legge le righe del blocco e le scrive direttamente
+ * nelle righe dell'archivio che iniziano da primo_cittadino[worker].
+ * Alla prima riga non valida si ferma e la annota in errore_blocco[worker]: l'errore viene segnalato
+ * dopo il passo, per il primo blocco in ordine di file, come nella lettura sequenziale.
+ * @param context Il LavoroParser condiviso.
+ * @param worker Indice del blocco.
+ * @param num_workers Numero totale di blocchi.
+ */
+static void parse_chunk_records(void *context, int worker, int num_workers) {
+    LavoroParser *job = (LavoroParser *)context;
+    const char *line = job->confini[worker];
+    const char *chunk_end = job->confini[worker + 1];
+    int c_idx = job->primo_cittadino[worker];
+    (void)num_workers;
+    while (line < chunk_end && c_idx < job->citizens->num_cittadini) {
+        const char *line_end = find_line_end(line, chunk_end);
+        if (!is_blank_line(line, line_end)) {
+            if (!parse_citizen_line(line, line_end, &job->citizens->viste[c_idx], job->citizens->num_progetti, job->index)) {
+                job->errore_blocco[worker] = c_idx + 1;
+                return;
+            }
+            c_idx++;
+        }
+        line = line_end + 1;
+    }
+}
 
-    for (c_idx = 0; c_idx < num_citizens; ++c_idx) {
-        /* Read citizen code and the first preferred project. */
-        fscanf(fp, "%s %s", citizens[c_idx]->CF, project_buffer);
+/**
+ * @brief Versione multi-thread di populate_citizen_data.
+ * La sezione cittadini viene divisa in blocchi allineati ai '\n'; un primo passo parallelo conta le righe
+ * di ogni blocco, la somma prefissa assegna a ciascun blocco il suo intervallo di indici e un secondo
+ * passo parallelo legge i cittadini al loro posto. L'ordine dei cittadini e' quindi quello del file,
+ * identico alla lettura sequenziale. Richiede un cittadino per riga, come da formato di input.
+ * @param cursor Inizio della sezione cittadini nel buffer.
+ * @param end Fine del buffer.
+ * @param citizens L'archivio (gia' allocato) da popolare.
+ * @param index L'indice hash dei nomi dei progetti per la lookup.
+ * @param num_workers Numero di thread da usare.
+ */
+static void populate_citizen_data_parallel(const char *cursor, const char *end, ArchivioCittadini *citizens, const IndiceProgetti *index, int num_workers) {
+    LavoroParser job;
+    size_t section_size = (size_t)(end - cursor);
+    int num_chunks = num_workers, w, total;
 
-        /* Allocate memory for project preferences (integers). */
-        citizens[c_idx]->progs = (int *)calloc(num_projects, sizeof(int));
+    if ((size_t)num_chunks > section_size / PARSER_BYTE_PER_THREAD) {
+        num_chunks = (int)(section_size / PARSER_BYTE_PER_THREAD);
+    }
+    if (num_chunks <= 1) {
+        populate_citizen_data(cursor, end, citizens, index);
+        return;
+    }
 
-        /* Allocate memory for preference operators (chars). */
-        citizens[c_idx]->pref = (char *)calloc(num_projects - 1, sizeof(char));
+    job.confini = (const char **)calloc(num_chunks + 1, sizeof(const char *));
+    job.righe_blocco = (int *)calloc(num_chunks, sizeof(int));
+    job.primo_cittadino = (int *)calloc(num_chunks, sizeof(int));
+    job.errore_blocco = (int *)calloc(num_chunks, sizeof(int));
+    if (!job.confini || !job.righe_blocco || !job.primo_cittadino || !job.errore_blocco) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per i blocchi del parser parallelo.\n");
+        exit(EXIT_FAILURE);
+    }
+    job.citizens = citizens;
+    job.index = index;
 
-        /* Find the index of the first preferred project. */
-        citizens[c_idx]->progs[0] = find_project_index_binary(project_names, 0, num_projects - 1, project_buffer);
+    /* Confini a intervalli regolari, spostati all'inizio della riga successiva */
+    job.confini[0] = cursor;
+    job.confini[num_chunks] = end;
+    for (w = 1; w < num_chunks; ++w) {
+        const char *boundary = cursor + section_size / num_chunks * w;
+        if (boundary < job.confini[w - 1]) {
+            boundary = job.confini[w - 1];
+        }
+        boundary = find_line_end(boundary, end);
+        job.confini[w] = (boundary < end) ? boundary + 1 : end;
+    }
 
-        /* Read the remaining project preferences and operators. */
-        for (p_idx = 1; p_idx < num_projects; ++p_idx) {
-            fscanf(fp, " %c %s", &citizens[c_idx]->pref[p_idx - 1], project_buffer);
-            citizens[c_idx]->progs[p_idx] = find_project_index_binary(project_names, 0, num_projects - 1, project_buffer);
+    run_parallel(num_chunks, count_chunk_records, &job);
+    for (w = 0, total = 0; w < num_chunks; ++w) {
+        job.primo_cittadino[w] = total;
+        total += job.righe_blocco[w];
+    }
+    run_parallel(num_chunks, parse_chunk_records, &job);
+    /* Prima riga non valida in ordine di file; poi le righe mancanti, come nella lettura sequenziale */
+    for (w = 0; w < num_chunks; ++w) {
+        if (job.errore_blocco[w]) {
+            fprintf(stderr, "ERRORE: Errore nel formato della riga cittadino %d: codice fiscale o preferenze non validi.\n", job.errore_blocco[w]);
+            exit(EXIT_FAILURE);
         }
     }
+    if (total < citizens->num_cittadini) {
+        fprintf(stderr, "ERRORE: Errore nel formato della riga cittadino %d: codice fiscale o preferenze non validi.\n", total + 1);
+        exit(EXIT_FAILURE);
+    }
+
+    free(job.confini);
+    free(job.righe_blocco);
+    free(job.primo_cittadino);
+    free(job.errore_blocco);
 }
+
 /**
- * @brief Chiude il file stream.
- * @param fp Il puntatore al FILE da chiudere.
+ * @brief Verifica se il contenuto del file inizia con la firma del formato binario.
+ * @param buffer Il contenuto del file.
+ * @return 1 se il file e' in formato binario, 0 se testuale.
  */
-static void close_data_file(FILE *fp) {
-    fclose(fp);
+static int is_binary_data(const BufferDati *buffer) {
+    return buffer->dimensione >= sizeof(IntestazioneBinaria) && memcmp(buffer->dati, BINARIO_FIRMA, 4) == 0;
+}
+
+/**
+ * @brief Valida l'intestazione del formato binario e individua l'inizio delle sezioni.
+ * @param buffer Il contenuto del file (mappato in memoria).
+ * @param params Dove memorizzare i parametri letti.
+ * @param sections Dove memorizzare l'inizio di ciascuna sezione.
+ */
+static void read_binary_layout(const BufferDati *buffer, ParametriInput *params, SezioniBinarie *sections) {
+    IntestazioneBinaria header;
+    size_t expected_size;
+
+    memcpy(&header, buffer->dati, sizeof(header)); /* Copia: la mappatura non garantisce allineamento */
+    if (header.versione != BINARIO_VERSIONE || header.controllo_ordine != BINARIO_CONTROLLO_ORDINE ||
+        header.dimensione_int != (int)sizeof(int) || header.lunghezza_progetto != PROG_LENGTH ||
+        header.lunghezza_cf != CF_LENGTH || header.num_abitanti < 0 || header.num_progetti < 1 ||
+        header.larghezza_ranking != select_rank_width(header.num_progetti)) {
+        fprintf(stderr, "ERRORE: File binario non compatibile (versione %d, attesa %d) o intestazione non valida.\n",
+                header.versione, BINARIO_VERSIONE);
+        exit(EXIT_FAILURE);
+    }
+    params->num_abitanti = header.num_abitanti;
+    params->num_progetti = header.num_progetti;
+    params->num_gruppi = header.num_gruppi;
+    check_group_count(params->num_gruppi);
+
+    sections->nomi = buffer->dati + sizeof(header);
+    sections->cf = sections->nomi + (size_t)params->num_progetti * (PROG_LENGTH + 1);
+    sections->indici = sections->cf + (size_t)params->num_abitanti * (CF_LENGTH + 1);
+    sections->simboli = sections->indici + (size_t)params->num_abitanti * params->num_progetti * header.larghezza_ranking;
+    expected_size = (size_t)(sections->simboli - buffer->dati) + (size_t)params->num_abitanti * (params->num_progetti - 1);
+    if (buffer->dimensione != expected_size) {
+        fprintf(stderr, "ERRORE: File binario troncato o corrotto (%lu byte, attesi %lu).\n",
+                (unsigned long)buffer->dimensione, (unsigned long)expected_size);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Copia la tabella ordinata dei nomi dei progetti dal formato binario.
+ * @param sections Le sezioni del file binario.
+ * @param num_projects Il numero di progetti.
+ * @param projects L'array (gia' allocato) dei nomi dei progetti.
+ */
+static void load_binary_projects(const SezioniBinarie *sections, int num_projects, char **projects) {
+    int i;
+    for (i = 0; i < num_projects; ++i) {
+        memcpy(projects[i], sections->nomi + (size_t)i * (PROG_LENGTH + 1), PROG_LENGTH + 1);
+        projects[i][PROG_LENGTH] = '\0';
+    }
+}
+
+/**
+ * @brief Copia in blocco codice fiscale, indici e simboli di un cittadino dal formato binario.
+ * @param sections Le sezioni del file binario.
+ * @param c_idx L'indice del cittadino nel file.
+ * @param num_projects Il numero di progetti.
+ * @param citizen Il cittadino da popolare (progs e pref gia' allocati).
+ */
+static void copy_binary_citizen(const SezioniBinarie *sections, int c_idx, int num_projects, cittadino *citizen) {
+    size_t row_bytes = (size_t)num_projects * citizen->larghezza;
+    int p_idx;
+    memcpy(citizen->CF, sections->cf + (size_t)c_idx * (CF_LENGTH + 1), CF_LENGTH + 1);
+    citizen->CF[CF_LENGTH] = '\0';
+    memcpy(citizen->progs.dati, sections->indici + (size_t)c_idx * row_bytes, row_bytes);
+    if (num_projects > 1) {
+        memcpy(citizen->pref, sections->simboli + (size_t)c_idx * (num_projects - 1), num_projects - 1);
+    }
+    for (p_idx = 0; p_idx < num_projects; ++p_idx) {
+        int rank = get_citizen_rank(citizen, p_idx);
+        if (rank < 0 || rank >= num_projects) {
+            fprintf(stderr, "ERRORE: Indice di progetto non valido nel file binario (cittadino %d).\n", c_idx + 1);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/**
+ * @brief Carica i dati dal formato binario: le sezioni hanno lo stesso layout delle tabelle
+ * dell'archivio, quindi bastano tre copie in blocco e nessuna ricerca sui nomi.
+ * @param buffer Il contenuto del file (mappato in memoria).
+ * @param params Dove memorizzare i parametri letti.
+ * @param citizens L'archivio dei cittadini da allocare e popolare.
+ * @param projects Puntatore al puntatore dell'array di nomi dei progetti.
+ */
+static void load_binary_data(const BufferDati *buffer, ParametriInput *params, ArchivioCittadini *citizens, char ***projects) {
+    SezioniBinarie sections;
+    size_t num_ranks, c_idx;
+    int p_idx;
+
+    read_binary_layout(buffer, params, &sections);
+
+    allocate_citizen_store(citizens, params->num_abitanti, params->num_progetti);
+    *projects = allocate_project_names_array(params->num_progetti);
+
+    load_binary_projects(&sections, params->num_progetti, *projects);
+    num_ranks = (size_t)params->num_abitanti * params->num_progetti;
+    memcpy(citizens->ranking, sections.indici, num_ranks * citizens->larghezza);
+    memcpy(citizens->codici, sections.cf, (size_t)params->num_abitanti * (CF_LENGTH + 1));
+    memcpy(citizens->simboli, sections.simboli, (size_t)params->num_abitanti * (params->num_progetti - 1));
+    for (c_idx = 0; c_idx < (size_t)params->num_abitanti; ++c_idx) {
+        citizens->codici[c_idx * (CF_LENGTH + 1) + CF_LENGTH] = '\0';
+    }
+    for (c_idx = 0; c_idx < (size_t)params->num_abitanti; ++c_idx) {
+        for (p_idx = 0; p_idx < params->num_progetti; ++p_idx) {
+            int rank = get_citizen_rank(citizens->elenco[c_idx], p_idx);
+            if (rank < 0 || rank >= params->num_progetti) {
+                fprintf(stderr, "ERRORE: Indice di progetto non valido nel file binario (cittadino %lu).\n",
+                        (unsigned long)(c_idx + 1));
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Prepara la lettura del formato testuale: parametri, nomi ordinati dei progetti e indice hash.
+ * @param buffer Il contenuto del file.
+ * @param params Dove memorizzare i parametri letti.
+ * @param projects Puntatore al puntatore dell'array di nomi dei progetti (allocato qui).
+ * @param index L'indice hash da costruire sui nomi ordinati.
+ * @return L'inizio della sezione cittadini (la riga successiva ai parametri).
+ */
+static const char *prepare_text_data(const BufferDati *buffer, ParametriInput *params, char ***projects, IndiceProgetti *index) {
+    const char *end = buffer->dati + buffer->dimensione;
+    const char *cursor = read_initial_params(buffer, params);
+    const char *citizen_section;
+
+    *projects = allocate_project_names_array(params->num_progetti);
+
+    load_project_names(cursor, end, params->num_progetti, *projects);
+    qsort_alfabetico(*projects, 0, params->num_progetti - 1);
+    build_project_index(index, *projects, params->num_progetti);
+
+    /* La sezione cittadini inizia dopo la prima riga, senza riposizionare alcuno stream */
+    citizen_section = buffer->dati;
+    while (citizen_section < end && *citizen_section != '\n') {
+        citizen_section++;
+    }
+    return citizen_section;
+}
+
+/**
+ * @brief Salva i dati gia' caricati nel formato binario compatto.
+ * @param filename Il file di destinazione.
+ * @param params I parametri iniziali.
+ * @param citizens L'archivio dei cittadini, con indici dei progetti gia' risolti.
+ * @param projects L'array ordinato dei nomi dei progetti.
+ */
+void save_binary_data(const char *filename, const ParametriInput *params, const ArchivioCittadini *citizens, char **projects) {
+    IntestazioneBinaria header;
+    char name_record[PROG_LENGTH + 1];
+    size_t num_citizens = (size_t)params->num_abitanti;
+    int i, ok;
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "ERRORE: Impossibile creare il file binario '%s'.\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.firma, BINARIO_FIRMA, 4);
+    header.versione = BINARIO_VERSIONE;
+    header.controllo_ordine = BINARIO_CONTROLLO_ORDINE;
+    header.dimensione_int = (int)sizeof(int);
+    header.lunghezza_progetto = PROG_LENGTH;
+    header.lunghezza_cf = CF_LENGTH;
+    header.num_abitanti = params->num_abitanti;
+    header.num_progetti = params->num_progetti;
+    header.num_gruppi = params->num_gruppi;
+    header.larghezza_ranking = citizens->larghezza;
+    ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    /* Record a lunghezza fissa azzerati: il file non dipende dal contenuto residuo dei buffer */
+    for (i = 0; ok && i < params->num_progetti; ++i) {
+        memset(name_record, 0, sizeof(name_record));
+        memcpy(name_record, projects[i], strlen(projects[i]));
+        ok = fwrite(name_record, sizeof(name_record), 1, fp) == 1;
+    }
+    /* Le tabelle dell'archivio hanno gia' il layout del file (codici azzerati dalla calloc): scrittura in blocco */
+    ok = ok && fwrite(citizens->codici, CF_LENGTH + 1, num_citizens, fp) == num_citizens;
+    ok = ok && fwrite(citizens->ranking, (size_t)citizens->larghezza * params->num_progetti, num_citizens, fp) == num_citizens;
+    if (params->num_progetti > 1) {
+        ok = ok && fwrite(citizens->simboli, params->num_progetti - 1, num_citizens, fp) == num_citizens;
+    }
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "ERRORE: Scrittura incompleta del file binario '%s'.\n", filename);
+        exit(EXIT_FAILURE);
+    }
 }
 
 /**
  * @brief Funzione principale per l'acquisizione di tutti i dati necessari all'applicazione.
+ * Il file viene mappato in memoria una sola volta: se inizia con la firma del formato binario
+ * viene copiato in blocco, altrimenti e' tokenizzato sul posto.
  * @param filename Il nome del file da cui leggere i dati.
  * @param params Puntatore alla struttura ParametriInput dove saranno memorizzati i parametri letti.
- * @param citizens Puntatore al puntatore dell'array di cittadini.
+ * @param citizens L'archivio dei cittadini da allocare e popolare.
  * @param projects Puntatore al puntatore dell'array di nomi dei progetti.
+ * @param num_workers Numero di thread per la lettura del formato testuale (1 = sequenziale).
  */
-void fetch_all_data(const char *filename, ParametriInput *params, cittadino ***citizens, char ***projects) {
-    FILE *data_source = attempt_file_open(filename);
+void fetch_all_data(const char *filename, ParametriInput *params, ArchivioCittadini *citizens, char ***projects, int num_workers) {
+    BufferDati data_source;
+    IndiceProgetti project_index;
+    const char *citizen_section;
 
-    read_initial_params(data_source, params);
+    map_data_file(filename, &data_source);
 
-    *citizens = allocate_citizen_array(params->num_abitanti);
-    *projects = allocate_project_names_array(params->num_progetti);
+    if (is_binary_data(&data_source)) {
+        load_binary_data(&data_source, params, citizens, projects);
+        unmap_data_file(&data_source);
+        return;
+    }
 
-    load_project_names(data_source, params->num_progetti, *projects);
-    qsort_alfabetico(*projects, 0, params->num_progetti - 1);
+    citizen_section = prepare_text_data(&data_source, params, projects, &project_index);
+    allocate_citizen_store(citizens, params->num_abitanti, params->num_progetti);
+    populate_citizen_data_parallel(citizen_section, data_source.dati + data_source.dimensione, citizens,
+                                   &project_index, num_workers);
+
+    free_project_index(&project_index);
+    unmap_data_file(&data_source);
+}
 
-    populate_citizen_data(data_source, *citizens, params->num_abitanti, params->num_progetti, *projects);
+/* === Sezione di Lettura Sequenziale (streaming) === */
 
-    close_data_file(data_source);
+/**
+ * @brief Apre un file di input per la lettura di un cittadino alla volta.
+ * Vengono caricati subito solo i parametri e i nomi ordinati dei progetti.
+ * @param filename Il nome del file da cui leggere i dati (testuale o binario).
+ * @param params Puntatore alla struttura ParametriInput dove saranno memorizzati i parametri letti.
+ * @param projects Puntatore al puntatore dell'array di nomi dei progetti.
+ * @return Il flusso aperto, da chiudere con close_citizen_stream.
+ */
+FlussoCittadini *open_citizen_stream(const char *filename, ParametriInput *params, char ***projects) {
+    FlussoCittadini *stream = (FlussoCittadini *)calloc(1, sizeof(FlussoCittadini));
+    if (!stream) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il flusso di lettura dei cittadini.\n");
+        exit(EXIT_FAILURE);
+    }
+    map_data_file(filename, &stream->buffer);
+    stream->binario = is_binary_data(&stream->buffer);
+    if (stream->binario) {
+        read_binary_layout(&stream->buffer, params, &stream->sezioni);
+        *projects = allocate_project_names_array(params->num_progetti);
+        load_binary_projects(&stream->sezioni, params->num_progetti, *projects);
+    } else {
+        stream->cursore = prepare_text_data(&stream->buffer, params, projects, &stream->indice);
+    }
+    stream->num_abitanti = params->num_abitanti;
+    stream->num_progetti = params->num_progetti;
+    stream->letti = 0;
+    allocate_citizen_store(&stream->corrente, 1, params->num_progetti);
+    return stream;
+}
+
+/**
+ * @brief Legge il prossimo cittadino dal flusso.
+ * @param stream Il flusso aperto con open_citizen_stream.
+ * @return Il cittadino letto, valido fino alla lettura successiva; NULL dopo l'ultimo cittadino.
+ */
+cittadino *read_next_citizen(FlussoCittadini *stream) {
+    const char *line, *line_end;
+    if (stream->letti >= stream->num_abitanti) {
+        return NULL;
+    }
+    if (stream->binario) {
+        copy_binary_citizen(&stream->sezioni, stream->letti, stream->num_progetti, stream->corrente.elenco[0]);
+    } else {
+        line = next_citizen_line(&stream->cursore, stream->buffer.dati + stream->buffer.dimensione, &line_end);
+        if (!line || !parse_citizen_line(line, line_end, stream->corrente.elenco[0], stream->num_progetti, &stream->indice)) {
+            fprintf(stderr, "ERRORE: Errore nel formato della riga cittadino %d: codice fiscale o preferenze non validi.\n", stream->letti + 1);
+            exit(EXIT_FAILURE);
+        }
+    }
+    stream->letti++;
+    return stream->corrente.elenco[0];
+}
+
+/**
+ * @brief Chiude il flusso e libera la memoria associata (i nomi dei progetti restano al chiamante).
+ * @param stream Il flusso da chiudere.
+ */
+void close_citizen_stream(FlussoCittadini *stream) {
+    if (!stream->binario) {
+        free_project_index(&stream->indice);
+    }
+    unmap_data_file(&stream->buffer);
+    free(stream->corrente.arena);
+    free(stream);
+}
+
+/* === Sezione di Lettura Incrementale (file in crescita) === */
+
+/**
+ * @brief Accoda al buffer al piu' CODA_BLOCCO_LETTURA byte aggiunti al file dall'ultima lettura.
+ * @param tail La coda aperta con open_citizen_tail.
+ * @return Il numero di byte nuovi (0 se il file non e' cresciuto).
+ */
+static size_t read_tail_bytes(CodaCittadini *tail) {
+    size_t letti_ora;
+    /* Compatta: i byte gia' consumati non servono piu' */
+    if (tail->inizio > 0) {
+        memmove(tail->dati, tail->dati + tail->inizio, tail->fine - tail->inizio);
+        tail->fine -= tail->inizio;
+        tail->inizio = 0;
+    }
+    if (tail->capacita - tail->fine < CODA_BLOCCO_LETTURA) { /* Solo per righe piu' lunghe di un blocco */
+        char *nuovi = (char *)realloc(tail->dati, tail->capacita * 2);
+        if (!nuovi) {
+            fprintf(stderr, "ERRORE: Allocazione fallita per il buffer di lettura incrementale.\n");
+            exit(EXIT_FAILURE);
+        }
+        tail->dati = nuovi;
+        tail->capacita *= 2;
+    }
+    clearerr(tail->fp); /* Dopo un EOF la lettura riprende se il file e' cresciuto */
+    letti_ora = fread(tail->dati + tail->fine, 1, CODA_BLOCCO_LETTURA, tail->fp);
+    tail->fine += letti_ora;
+    return letti_ora;
+}
+
+/**
+ * @brief Apre un file testuale per la lettura incrementale dei cittadini.
+ * Servono la riga dei parametri e la prima riga cittadino (da cui si leggono i nomi dei progetti), entrambe
+ * terminate da '\n': se non sono ancora state scritte il file viene chiuso e la funzione restituisce NULL.
+ * @param filename Il nome del file da seguire.
+ * @param params Puntatore alla struttura ParametriInput dove saranno memorizzati i parametri letti.
+ * @param projects Puntatore al puntatore dell'array di nomi dei progetti.
+ * @return La coda aperta, da chiudere con close_citizen_tail; NULL se l'intestazione e' ancora incompleta.
+ */
+CodaCittadini *open_citizen_tail(const char *filename, ParametriInput *params, char ***projects) {
+    CodaCittadini *tail = (CodaCittadini *)calloc(1, sizeof(CodaCittadini));
+    BufferDati header;
+    const char *citizen_section, *second_line;
+    if (!tail) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per la lettura incrementale dei cittadini.\n");
+        exit(EXIT_FAILURE);
+    }
+    tail->fp = fopen(filename, "rb");
+    if (!tail->fp) {
+        fprintf(stderr, "ERRORE: Impossibile aprire il file '%s'. Controllare percorso o permessi.\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    tail->capacita = 2 * CODA_BLOCCO_LETTURA;
+    tail->dati = (char *)malloc(tail->capacita);
+    if (!tail->dati) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il buffer di lettura incrementale.\n");
+        exit(EXIT_FAILURE);
+    }
+    /* Legge finche' le prime due righe non sono complete o il file non finisce */
+    do {
+        second_line = (const char *)memchr(tail->dati, '\n', tail->fine);
+        if (second_line && memchr(second_line + 1, '\n', tail->fine - (size_t)(second_line + 1 - tail->dati))) {
+            break;
+        }
+    } while (read_tail_bytes(tail) > 0);
+
+    header.dati = tail->dati;
+    header.dimensione = tail->fine;
+    header.mappato = 0;
+    if (is_binary_data(&header)) {
+        fprintf(stderr, "ERRORE: La lettura incrementale richiede il formato testuale.\n");
+        exit(EXIT_FAILURE);
+    }
+    second_line = (const char *)memchr(tail->dati, '\n', tail->fine);
+    if (!second_line || !memchr(second_line + 1, '\n', tail->fine - (size_t)(second_line + 1 - tail->dati))) {
+        fclose(tail->fp); /* Intestazione non ancora scritta per intero */
+        free(tail->dati);
+        free(tail);
+        return NULL;
+    }
+
+    citizen_section = prepare_text_data(&header, params, projects, &tail->indice);
+    tail->inizio = (size_t)(citizen_section - tail->dati);
+    tail->num_abitanti = params->num_abitanti;
+    tail->num_progetti = params->num_progetti;
+    tail->letti = 0;
+    allocate_citizen_store(&tail->corrente, 1, params->num_progetti);
+    return tail;
+}
+
+/**
+ * @brief Restituisce il prossimo cittadino aggiunto al file, se la sua riga e' gia' completa.
+ * Una riga viene letta solo quando e' terminata da '\n', quindi una scrittura in corso non viene mai spezzata.
+ * @param tail La coda aperta con open_citizen_tail.
+ * @return Il cittadino letto, valido fino alla lettura successiva; NULL se non ci sono righe nuove
+ *         complete o se sono gia' stati letti tutti i cittadini dichiarati.
+ */
+cittadino *read_appended_citizen(CodaCittadini *tail) {
+    const char *line, *line_end;
+    while (tail->letti < tail->num_abitanti) {
+        line = tail->dati + tail->inizio;
+        line_end = (const char *)memchr(line, '\n', tail->fine - tail->inizio);
+        if (!line_end) {
+            if (read_tail_bytes(tail) == 0) {
+                return NULL; /* Nessuna riga completa nuova: si riprova al prossimo aggiornamento */
+            }
+            continue;
+        }
+        tail->inizio = (size_t)(line_end + 1 - tail->dati);
+        if (is_blank_line(line, line_end)) {
+            continue;
+        }
+        if (!parse_citizen_line(line, line_end, tail->corrente.elenco[0], tail->num_progetti, &tail->indice)) {
+            fprintf(stderr, "ERRORE: Errore nel formato della riga cittadino %d: codice fiscale o preferenze non validi.\n", tail->letti + 1);
+            exit(EXIT_FAILURE);
+        }
+        tail->letti++;
+        return tail->corrente.elenco[0];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Numero di cittadini letti finora dalla coda.
+ * @param tail La coda aperta con open_citizen_tail.
+ * @return I cittadini gia' restituiti da read_appended_citizen.
+ */
+int citizens_read_from_tail(const CodaCittadini *tail) {
+    return tail->letti;
+}
+
+/**
+ * @brief Chiude il file seguito e libera la memoria associata (i nomi dei progetti restano al chiamante).
+ * @param tail La coda da chiudere.
+ */
+void close_citizen_tail(CodaCittadini *tail) {
+    free_project_index(&tail->indice);
+    fclose(tail->fp);
+    free(tail->dati);
+    free(tail->corrente.arena);
+    free(tail);
 }
 
 /* === Sezione di Allocazione per Metodi di Votazione e Clustering === */
 
+/**
+ * @brief Calcola l'hash FNV-1a (32 bit) di una scheda: indici dei progetti e simboli di preferenza.
+ * @param citizen Il cittadino.
+ * @param rank_bytes Byte della riga di indici.
+ * @param pref_bytes Byte della riga di simboli.
+ * @return Il valore hash.
+ */
+static unsigned long hash_ballot(const cittadino *citizen, size_t rank_bytes, size_t pref_bytes) {
+    const unsigned char *ranks = (const unsigned char *)citizen->progs.dati;
+    unsigned long h = 2166136261UL;
+    size_t i;
+    for (i = 0; i < rank_bytes; ++i) {
+        h ^= ranks[i];
+        h = (h * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    for (i = 0; i < pref_bytes; ++i) {
+        h ^= (unsigned char)citizen->pref[i];
+        h = (h * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return h;
+}
+
+/**
+ * @brief Raggruppa i cittadini con schede identiche (stesso ranking e stessi simboli) in classi pesate.
+ * Le classi sono numerate nell'ordine di prima comparsa; il rappresentante di ciascuna e' il cittadino
+ * con codice fiscale minimo, cosi' le regole di parita' del clustering restano quelle per cittadino.
+ * @param citizens L'archivio dei cittadini gia' popolato.
+ * @param classes Le classi da calcolare (da liberare con free_all_resources).
+ */
+void group_ballot_classes(const ArchivioCittadini *citizens, ClassiSchede *classes) {
+    int num_citizens = citizens->num_cittadini;
+    size_t rank_bytes = (size_t)citizens->num_progetti * citizens->larghezza;
+    size_t pref_bytes = (size_t)(citizens->num_progetti > 1 ? citizens->num_progetti - 1 : 0);
+    size_t count = (size_t)(num_citizens > 0 ? num_citizens : 1);
+    unsigned long capacity = 16, mask, pos, h;
+    unsigned long *slot_hash;
+    int *slot;
+    int c_idx, class_idx;
+
+    while (capacity < 2UL * (unsigned long)num_citizens) { /* Fattore di carico <= 0.5 */
+        capacity <<= 1;
+    }
+    mask = capacity - 1;
+    slot = (int *)malloc(capacity * sizeof(int));
+    slot_hash = (unsigned long *)malloc(capacity * sizeof(unsigned long));
+    classes->classe_di = (int *)malloc(count * sizeof(int));
+    classes->peso = (int *)calloc(count, sizeof(int));
+    classes->rappresentante = (int *)malloc(count * sizeof(int));
+    if (!slot || !slot_hash || !classes->classe_di || !classes->peso || !classes->rappresentante) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per le classi di schede.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (pos = 0; pos < capacity; ++pos) {
+        slot[pos] = -1;
+    }
+
+    classes->num_classi = 0;
+    for (c_idx = 0; c_idx < num_citizens; ++c_idx) {
+        const cittadino *citizen = citizens->elenco[c_idx];
+        h = hash_ballot(citizen, rank_bytes, pref_bytes);
+        pos = h & mask;
+        while (slot[pos] >= 0) { /* Scansione lineare fino alla stessa scheda o a uno slot vuoto */
+            const cittadino *other = citizens->elenco[classes->rappresentante[slot[pos]]];
+            if (slot_hash[pos] == h && memcmp(other->progs.dati, citizen->progs.dati, rank_bytes) == 0 &&
+                memcmp(other->pref, citizen->pref, pref_bytes) == 0) {
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+        if (slot[pos] < 0) { /* Prima comparsa di questa scheda: nuova classe */
+            slot[pos] = classes->num_classi;
+            slot_hash[pos] = h;
+            classes->rappresentante[classes->num_classi] = c_idx;
+            classes->num_classi++;
+        }
+        class_idx = slot[pos];
+        classes->classe_di[c_idx] = class_idx;
+        classes->peso[class_idx]++;
+        if (strcmp(citizen->CF, citizens->elenco[classes->rappresentante[class_idx]]->CF) < 0) {
+            classes->rappresentante[class_idx] = c_idx;
+        }
+    }
+    free(slot);
+    free(slot_hash);
+}
+
 /**
  * @brief Inizializza e alloca un array di puntatori a strutture 'contatore'.
  * @param count La dimensione dell'array.
@@ -223,26 +1398,238 @@ contatore **initialize_counter_array(int count) {
 }
 
 /**
- * @brief Alloca una matrice di interi e la inizializza a zero.
+ * @brief Abilita o disabilita le huge pages per le matrici di almeno MATRICE_SOGLIA_PAGINE_GRANDI byte.
+ * Senza supporto (mmap con MADV_HUGEPAGE) l'impostazione non ha effetto.
+ * @param enabled 1 per abilitare, 0 per disabilitare.
+ */
+void use_huge_pages(int enabled) {
+    matrici_pagine_grandi = enabled;
+}
+
+/**
+ * @brief Alloca una matrice contigua e azzerata in un unico blocco allineato a MATRICE_ALLINEAMENTO.
+ * Il passo delle righe e' arrotondato all'allineamento, quindi ogni riga inizia su una linea di cache.
+ * @param matrix La matrice da inizializzare.
  * @param rows Il numero di righe.
  * @param cols Il numero di colonne.
- * @return La matrice allocata.
+ * @param width Byte per elemento (sizeof(int) o select_rank_width).
  */
-vint *allocate_int_matrix(int rows, int cols) {
-    vint *matrix = (int **)calloc(rows, sizeof(vint));
-    int r;
-    if (!matrix) {
-        fprintf(stderr, "ERRORE: Allocazione fallita per la matrice principale.\n");
+void allocate_matrix(Matrice *matrix, int rows, int cols, int width) {
+    size_t count = (size_t)(rows > 0 ? rows : 0);
+    size_t misalignment;
+
+    matrix->num_righe = rows;
+    matrix->num_colonne = cols;
+    matrix->larghezza = width;
+    matrix->passo = ((size_t)(cols > 0 ? cols : 0) * width + MATRICE_ALLINEAMENTO - 1) / MATRICE_ALLINEAMENTO * MATRICE_ALLINEAMENTO;
+    if (count > 0 && matrix->passo > (size_t)-1 / count - MATRICE_ALLINEAMENTO) {
+        fprintf(stderr, "ERRORE: Matrice troppo grande (%d x %d).\n", rows, cols);
         exit(EXIT_FAILURE);
     }
-    for (r = 0; r < rows; ++r) {
-        matrix[r] = (int *)calloc(cols, sizeof(int));
-        if (!matrix[r]) {
-            fprintf(stderr, "ERRORE: Allocazione fallita per la riga %d della matrice.\n", r);
-            exit(EXIT_FAILURE);
+    matrix->dimensione = count * matrix->passo;
+    matrix->pagine_grandi = 0;
+
+#if DM_USA_PAGINE_GRANDI
+    if (matrici_pagine_grandi && matrix->dimensione >= MATRICE_SOGLIA_PAGINE_GRANDI) {
+        /* Pagine anonime (gia' azzerate) arrotondate a multipli della soglia, poi il suggerimento al kernel */
+        size_t bytes = (matrix->dimensione + MATRICE_SOGLIA_PAGINE_GRANDI - 1) / MATRICE_SOGLIA_PAGINE_GRANDI * MATRICE_SOGLIA_PAGINE_GRANDI;
+        void *area = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (area != MAP_FAILED) {
+            madvise(area, bytes, MADV_HUGEPAGE); /* Se THP non e' attivo restano pagine normali */
+            matrix->blocco = area;
+            matrix->dati = (char *)area;
+            matrix->dimensione = bytes;
+            matrix->pagine_grandi = 1;
+            return;
+        }
+    }
+#endif
+    matrix->blocco = calloc(matrix->dimensione + MATRICE_ALLINEAMENTO, 1);
+    if (!matrix->blocco) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per una matrice %d x %d.\n", rows, cols);
+        exit(EXIT_FAILURE);
+    }
+    misalignment = (size_t)((unsigned long)matrix->blocco % MATRICE_ALLINEAMENTO);
+    matrix->dati = (char *)matrix->blocco + (misalignment ? MATRICE_ALLINEAMENTO - misalignment : 0);
+}
+
+/**
+ * @brief Libera una matrice allocata con allocate_matrix (una sola free o munmap).
+ * @param matrix La matrice da liberare.
+ */
+void free_matrix(Matrice *matrix) {
+    if (!matrix->blocco) {
+        return;
+    }
+#if DM_USA_PAGINE_GRANDI
+    if (matrix->pagine_grandi) {
+        munmap(matrix->blocco, matrix->dimensione);
+        matrix->blocco = NULL;
+        matrix->dati = NULL;
+        return;
+    }
+#endif
+    free(matrix->blocco);
+    matrix->blocco = NULL;
+    matrix->dati = NULL;
+}
+
+/**
+ * @brief Sceglie la larghezza minima delle distanze L1 tra righe Borda.
+ * Ogni punteggio Borda e' compreso tra 0 e num_projects, quindi una distanza non supera num_projects^2.
+ * @param num_projects Il numero di progetti.
+ * @return 1 (unsigned char), 2 (unsigned short) o 4 (int) byte per elemento.
+ */
+int select_distance_width(int num_projects) {
+    unsigned long max_distance = (unsigned long)num_projects * (unsigned long)num_projects;
+    if (max_distance <= UCHAR_MAX) {
+        return 1;
+    }
+    if (max_distance <= USHRT_MAX) {
+        return 2;
+    }
+    return (int)sizeof(int);
+}
+
+/**
+ * @brief Posizione della coppia (i, j), con i < j, nel triangolo superiore impacchettato.
+ * @param num_rows Il numero di righe.
+ * @param i La riga (minore).
+ * @param j La colonna (maggiore).
+ * @return L'indice dell'elemento.
+ */
+static size_t triangle_offset(int num_rows, int i, int j) {
+    return (size_t)i * (2 * (size_t)num_rows - (size_t)i - 1) / 2 + (size_t)(j - i - 1);
+}
+
+/**
+ * @brief Alloca il triangolo superiore (senza diagonale) delle distanze tra num_rows righe Borda.
+ * Se il triangolo supera il budget la memoria non viene allocata e dati resta NULL: il chiamante
+ * ricalcolera' le distanze quando servono.
+ * @param distances La struttura da inizializzare.
+ * @param num_rows Il numero di righe (classi di schede).
+ * @param num_projects Il numero di progetti, che limita la distanza massima.
+ * @param budget Memoria massima (byte) per il triangolo.
+ */
+void allocate_distance_store(DistanzeTriangolari *distances, int num_rows, int num_projects, size_t budget) {
+    size_t count = (size_t)(num_rows > 1 ? num_rows : 1);
+    size_t pairs = count * (count - 1) / 2;
+    distances->num_righe = num_rows;
+    distances->larghezza = select_distance_width(num_projects);
+    distances->dati = NULL;
+    if (count > 1 && (count - 1) > ((size_t)-1 / count) / (size_t)distances->larghezza) {
+        return; /* Non rappresentabile: certamente oltre il budget */
+    }
+    if (pairs * distances->larghezza > budget) {
+        return;
+    }
+    distances->dati = malloc(pairs > 0 ? pairs * distances->larghezza : 1);
+    if (!distances->dati) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per la matrice delle distanze (%d righe).\n", num_rows);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief Scrive le distanze della riga i verso le colonne da first a first + count - 1, contigue nel triangolo.
+ * Segmenti disgiunti possono essere scritti da thread diversi.
+ * @param distances Le distanze.
+ * @param i La riga.
+ * @param first La prima colonna (maggiore di i).
+ * @param count Numero di colonne.
+ * @param distances_after Le distanze da i a j in posizione j - first.
+ */
+void store_distance_segment(DistanzeTriangolari *distances, int i, int first, int count, const int *distances_after) {
+    size_t base, k;
+    if (count <= 0) {
+        return;
+    }
+    base = triangle_offset(distances->num_righe, i, first);
+    switch (distances->larghezza) {
+        case 1:
+            for (k = 0; k < (size_t)count; ++k) {
+                ((unsigned char *)distances->dati)[base + k] = (unsigned char)distances_after[k];
+            }
+            break;
+        case 2:
+            for (k = 0; k < (size_t)count; ++k) {
+                ((unsigned short *)distances->dati)[base + k] = (unsigned short)distances_after[k];
+            }
+            break;
+        default:
+            memcpy((int *)distances->dati + base, distances_after, (size_t)count * sizeof(int));
+            break;
+    }
+}
+
+/**
+ * @brief Ricostruisce la riga i completa delle distanze: la parte j < i si legge per colonna
+ * nel triangolo, la parte j > i e' contigua.
+ * @param distances Le distanze.
+ * @param i La riga.
+ * @param row Vettore di num_righe int da riempire (row[i] = 0).
+ */
+void copy_distance_row(const DistanzeTriangolari *distances, int i, int *row) {
+    int n = distances->num_righe, j;
+    size_t offset;
+    switch (distances->larghezza) {
+        case 1: {
+            const unsigned char *d = (const unsigned char *)distances->dati;
+            for (j = 0, offset = (size_t)i - 1; j < i; ++j) {
+                row[j] = d[offset];
+                offset += (size_t)(n - j - 2); /* Stessa colonna i nella riga j + 1 */
+            }
+            row[i] = 0;
+            for (j = i + 1, offset = triangle_offset(n, i, i + 1); j < n; ++j, ++offset) {
+                row[j] = d[offset];
+            }
+            break;
+        }
+        case 2: {
+            const unsigned short *d = (const unsigned short *)distances->dati;
+            for (j = 0, offset = (size_t)i - 1; j < i; ++j) {
+                row[j] = d[offset];
+                offset += (size_t)(n - j - 2);
+            }
+            row[i] = 0;
+            for (j = i + 1, offset = triangle_offset(n, i, i + 1); j < n; ++j, ++offset) {
+                row[j] = d[offset];
+            }
+            break;
         }
+        default: {
+            const int *d = (const int *)distances->dati;
+            for (j = 0, offset = (size_t)i - 1; j < i; ++j) {
+                row[j] = d[offset];
+                offset += (size_t)(n - j - 2);
+            }
+            row[i] = 0;
+            if (i < n - 1) {
+                memcpy(row + i + 1, d + triangle_offset(n, i, i + 1), (size_t)(n - i - 1) * sizeof(int));
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Restituisce la distanza tra due righe.
+ * @param distances Le distanze.
+ * @param i La prima riga.
+ * @param j La seconda riga.
+ * @return La distanza (0 se i == j).
+ */
+int get_distance(const DistanzeTriangolari *distances, int i, int j) {
+    size_t offset;
+    if (i == j) {
+        return 0;
+    }
+    offset = i < j ? triangle_offset(distances->num_righe, i, j) : triangle_offset(distances->num_righe, j, i);
+    switch (distances->larghezza) {
+        case 1: return ((const unsigned char *)distances->dati)[offset];
+        case 2: return ((const unsigned short *)distances->dati)[offset];
+        default: return ((const int *)distances->dati)[offset];
     }
-    return matrix;
 }
 
 /**
@@ -272,17 +1659,17 @@ componente **initialize_component_array(int count) {
 
 /**
  * @brief Libera tutta la memoria dinamica allocata durante l'esecuzione del programma.
- * @param num_citizens Numero di abitanti.
  * @param num_projects Numero di progetti.
  * @param projects_data Array di nomi di progetti.
- * @param citizens_data Array di strutture cittadino.
+ * @param citizens_data Archivio dei cittadini (puo' essere NULL).
+ * @param ballot_classes Classi di schede (puo' essere NULL).
  * @param method_counters Array di contatori per i metodi di votazione.
  * @param borda_matrix Matrice di Borda.
  * @param condorcet_matrix Matrice di Condorcet.
- * @param distance_matrix Matrice delle distanze per il clustering.
+ * @param distance_store Distanze (triangolo superiore) per il clustering.
  */
-void free_all_resources(int num_citizens, int num_projects, char **projects_data, cittadino **citizens_data,
-                        contatore **method_counters, vint *borda_matrix, vint *condorcet_matrix, vint *distance_matrix) {
+void free_all_resources(int num_projects, char **projects_data, ArchivioCittadini *citizens_data,
+                        ClassiSchede *ballot_classes, contatore **method_counters, Matrice *borda_matrix, Matrice *condorcet_matrix, DistanzeTriangolari *distance_store) {
 	int i;
     /* Libera memoria per i nomi dei progetti */
     if (projects_data) {
@@ -291,28 +1678,22 @@ void free_all_resources(int num_citizens, int num_projects, char **projects_data
         }
         free(projects_data);
     }
-    /* Libera memoria per le strutture cittadino */
-    /* Deallocate citizens_data */
+    /* Libera l'archivio dei cittadini: viste e tabelle stanno in un unico blocco */
     if (citizens_data != NULL) {
-        for (i = 0; i < num_citizens; ++i) {
-            if (citizens_data[i] != NULL) {
-                /* Free dynamically allocated members within each cittadino struct */
-                if (citizens_data[i]->progs != NULL) {
-                    free(citizens_data[i]->progs);
-                    citizens_data[i]->progs = NULL;
-                }
-                if (citizens_data[i]->pref != NULL) {
-                    free(citizens_data[i]->pref);
-                    citizens_data[i]->pref = NULL;
-                }
-                /* Free the cittadino struct itself */
-                free(citizens_data[i]);
-                citizens_data[i] = NULL;
-            }
-        }
-        /* Free the array of cittadino pointers */
-        free(citizens_data);
-        citizens_data = NULL;
+        free(citizens_data->arena);
+        citizens_data->arena = NULL;
+        citizens_data->elenco = NULL;
+        citizens_data->viste = NULL;
+    }
+
+    /* Libera le classi di schede */
+    if (ballot_classes != NULL) {
+        free(ballot_classes->classe_di);
+        free(ballot_classes->peso);
+        free(ballot_classes->rappresentante);
+        ballot_classes->classe_di = NULL;
+        ballot_classes->peso = NULL;
+        ballot_classes->rappresentante = NULL;
     }
 
     /* Libera memoria per i contatori dei metodi di votazione */
@@ -322,27 +1703,15 @@ void free_all_resources(int num_citizens, int num_projects, char **projects_data
         }
         free(method_counters);
     }
-    /* Libera memoria per la matrice di Borda */
+    /* Libera le matrici: un unico blocco ciascuna */
     if (borda_matrix) {
-        for (i = 0; i < num_citizens; ++i) { /* Matrice [num_citizens][num_projects] */
-            free(borda_matrix[i]);
-        }
-        free(borda_matrix);
+        free_matrix(borda_matrix);
     }
-
-    /* Libera memoria per la matrice di Condorcet */
     if (condorcet_matrix) {
-        for (i = 0; i < num_projects; ++i) {
-            free(condorcet_matrix[i]);
-        }
-        free(condorcet_matrix);
+        free_matrix(condorcet_matrix);
     }
-
-    /* Libera memoria per la matrice delle distanze (clustering) */
-    if (distance_matrix) {
-        for (i = 0; i < num_citizens; ++i) {
-            free(distance_matrix[i]);
-        }
-        free(distance_matrix);
+    if (distance_store) {
+        free(distance_store->dati);
+        distance_store->dati = NULL;
     }
 }
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 /* Definizione delle costanti */
 #ifndef NUM_PARAM_INIZIALI
@@ -18,11 +19,38 @@
 #ifndef CF_LENGTH
 #define CF_LENGTH 16
 #endif
+/* Dimensione minima (byte) della porzione di file letta da ciascun thread del parser */
+#ifndef PARSER_BYTE_PER_THREAD
+#define PARSER_BYTE_PER_THREAD (1UL << 20)
+#endif
+/* Allineamento (byte) dell'inizio e del passo delle righe di ogni matrice: una linea di cache */
+#ifndef MATRICE_ALLINEAMENTO
+#define MATRICE_ALLINEAMENTO 64
+#endif
+/* Dimensione minima (byte) da cui una matrice puo' usare le huge pages, se richieste */
+#ifndef MATRICE_SOGLIA_PAGINE_GRANDI
+#define MATRICE_SOGLIA_PAGINE_GRANDI (1UL << 21)
+#endif
+/* Memoria (byte) concessa alle distanze del clustering per ogni abitante: oltre, si ricalcolano al volo */
+#ifndef DISTANZE_BYTE_PER_ABITANTE
+#define DISTANZE_BYTE_PER_ABITANTE 4096UL
+#endif
+/* Formato binario compatto: firma iniziale e versione corrente */
+#define BINARIO_FIRMA "ELZB"
+#define BINARIO_VERSIONE 2
 /* Strutture dati astratte */
 
 typedef int* vint;
 typedef char* vchar;
 
+/* Riga di indici di progetto (o di punteggi Borda) alla larghezza minima scelta da select_rank_width */
+typedef union {
+    unsigned char *u8;   /* num_progetti <= UCHAR_MAX */
+    unsigned short *u16; /* num_progetti <= USHRT_MAX */
+    int *i32;            /* tutti gli altri casi */
+    void *dati;
+} vrank;
+
 /* Definizione della struttura per i parametri di input iniziali */
 typedef struct {
     int num_abitanti;
@@ -30,9 +58,11 @@ typedef struct {
     int num_gruppi;
 } ParametriInput;
 struct cittadino {
-    char CF[CF_LENGTH + 1];
-    vint progs; /* Array di indici dei progetti preferiti */
-    vchar pref;  /* Array di operatori di preferenza (es. '>', '<') */
+    vchar CF;    /* Codice fiscale, nella tabella dei codici dell'archivio */
+    vrank progs; /* Array di indici dei progetti preferiti (riga della matrice dei ranking) */
+    vchar pref;  /* Array di operatori di preferenza (es. '>', '<'), riga della matrice dei simboli */
+    int larghezza; /* Byte per indice in progs: 1, 2 o 4 */
+    int rango_cf;  /* Posizione di CF nell'ordine dei codici distinti (rank_citizen_codes): codici uguali, rango uguale */
 };
 struct componente {
     int min; /* Valore minimo di distanza */
@@ -47,6 +77,72 @@ typedef struct cittadino cittadino;
 typedef struct componente componente;
 typedef struct contatore contatore;
 
+/**
+ * Archivio contiguo dei cittadini (structure of arrays): ranking, simboli e codici fiscali stanno
+ * in tabelle piatte dentro un unico blocco di memoria; ogni 'cittadino' e' solo una vista sulle sue righe.
+ */
+typedef struct {
+    int num_cittadini;
+    int num_progetti;
+    int larghezza;       /* Byte per elemento di ranking, scelti da select_rank_width */
+    void *ranking;       /* num_cittadini x num_progetti indici dei progetti */
+    vchar simboli;       /* num_cittadini x (num_progetti - 1) simboli di preferenza, piu' un terminatore */
+    vchar codici;        /* num_cittadini x (CF_LENGTH + 1) codici fiscali */
+    cittadino *viste;    /* Una vista per cittadino sulle tabelle precedenti */
+    cittadino **elenco;  /* Puntatori alle viste, per le funzioni che lavorano su cittadino ** */
+    void *arena;         /* Unico blocco allocato che contiene tutto quanto sopra */
+} ArchivioCittadini;
+
+/**
+ * Matrice contigua: un unico blocco allineato a MATRICE_ALLINEAMENTO, con righe a passo costante
+ * arrotondato allo stesso allineamento. Gli elementi sono int per Condorcet e distanze; per i punteggi
+ * Borda (che non superano num_progetti) hanno la larghezza degli indici di progetto. I byte di riempimento
+ * tra la fine di una riga e l'inizio della successiva restano a zero.
+ */
+typedef struct {
+    char *dati;          /* Inizio della prima riga, allineato */
+    void *blocco;        /* Memoria allocata, da liberare con free_matrix */
+    size_t dimensione;   /* Byte allocati */
+    size_t passo;        /* Byte tra l'inizio di due righe consecutive */
+    int num_righe;
+    int num_colonne;
+    int larghezza;       /* Byte per elemento: 1, 2 o 4 */
+    int pagine_grandi;   /* 1 se allocata con mmap e huge pages */
+} Matrice;
+
+/**
+ * Distanze tra le righe Borda, simmetriche e nulle sulla diagonale: si memorizza solo il triangolo superiore
+ * (i < j) impacchettato riga per riga. Le distanze non superano num_progetti^2, quindi gli elementi sono
+ * da 1, 2 o 4 byte secondo select_distance_width. Se il triangolo supera il budget di memoria, dati resta
+ * NULL e il clustering ricalcola ogni riga di distanze dalla matrice Borda (modalita' senza matrice).
+ */
+typedef struct {
+    void *dati;          /* num_righe * (num_righe - 1) / 2 elementi, o NULL senza matrice */
+    int num_righe;
+    int larghezza;       /* Byte per elemento: 1, 2 o 4 */
+} DistanzeTriangolari;
+
+/* Riga r di una matrice, generica o di int */
+#define MATRICE_RIGA(m, r) ((void *)((m)->dati + (size_t)(r) * (m)->passo))
+#define MATRICE_INT(m, r) ((int *)MATRICE_RIGA(m, r))
+
+/**
+ * Classi di schede identiche: cittadini con lo stesso ranking e gli stessi simboli di preferenza.
+ * I metodi lavorano una volta per classe, pesando per il numero di cittadini; i risultati restano per cittadino.
+ */
+typedef struct {
+    int num_classi;
+    int *classe_di;      /* Per cittadino: indice della sua classe */
+    int *peso;           /* Per classe: numero di cittadini con quella scheda */
+    int *rappresentante; /* Per classe: il cittadino con codice fiscale minimo (il primo, a parita') */
+} ClassiSchede;
+
+/* Lettura sequenziale dei cittadini (struttura opaca, definita in data_manager.c) */
+typedef struct FlussoCittadini FlussoCittadini;
+
+/* Lettura incrementale di un file testuale in crescita (struttura opaca, definita in data_manager.c) */
+typedef struct CodaCittadini CodaCittadini;
+
 
 
 /* ------------------------ */
@@ -55,18 +151,76 @@ typedef struct contatore contatore;
 
 /* === Sezione di Gestione Iniziale Dati e Allocazione === */
 
-/* Procedura principale per l'acquisizione di tutti i dati dal file */
-void fetch_all_data(const char *filename, ParametriInput *params, cittadino ***citizens, char ***projects);
+/* Procedura principale per l'acquisizione di tutti i dati dal file (testuale o binario, riconosciuto dalla firma) */
+void fetch_all_data(const char *filename, ParametriInput *params, ArchivioCittadini *citizens, char ***projects, int num_workers);
+
+/* Assegna a ogni cittadino il rango denso del suo codice fiscale, per confrontare i codici come interi */
+void rank_citizen_codes(ArchivioCittadini *citizens);
+
+/* Salva i dati gia' caricati nel formato binario compatto, letto poi da fetch_all_data senza parsing */
+void save_binary_data(const char *filename, const ParametriInput *params, const ArchivioCittadini *citizens, char **projects);
+
+/* Apre il file per leggere un cittadino alla volta: carica solo parametri e nomi dei progetti */
+FlussoCittadini *open_citizen_stream(const char *filename, ParametriInput *params, char ***projects);
+
+/* Restituisce il prossimo cittadino (sovrascritto alla lettura successiva), NULL al termine */
+cittadino *read_next_citizen(FlussoCittadini *stream);
+
+/* Chiude il flusso e ne libera la memoria */
+void close_citizen_stream(FlussoCittadini *stream);
+
+/* Apre un file testuale in crescita; NULL se parametri e prima riga cittadino non sono ancora completi */
+CodaCittadini *open_citizen_tail(const char *filename, ParametriInput *params, char ***projects);
+
+/* Restituisce il prossimo cittadino aggiunto al file (sovrascritto alla lettura successiva), NULL se non ce ne sono */
+cittadino *read_appended_citizen(CodaCittadini *tail);
+
+/* Numero di cittadini letti finora dalla coda */
+int citizens_read_from_tail(const CodaCittadini *tail);
+
+/* Chiude la coda e ne libera la memoria */
+void close_citizen_tail(CodaCittadini *tail);
 
 
 
 /* === Sezione di Allocazione per Metodi di Votazione e Clustering === */
 
+/* Raggruppa i cittadini con schede identiche in classi pesate */
+void group_ballot_classes(const ArchivioCittadini *citizens, ClassiSchede *classes);
+
+/* Sceglie la larghezza minima (1, 2 o 4 byte) per indici di progetto e punteggi Borda */
+int select_rank_width(int num_projects);
+
+/* Legge l'indice di progetto in posizione pos di un cittadino, qualunque sia la larghezza */
+int get_citizen_rank(const cittadino *citizen, int pos);
+
 /* Alloca e inizializza un array di puntatori a strutture 'contatore' */
 contatore **initialize_counter_array(int count);
 
-/* Alloca una matrice di interi di dimensioni rows x cols */
-vint *allocate_int_matrix(int rows, int cols);
+/* Alloca una matrice contigua e azzerata di rows x cols elementi da 'width' byte */
+void allocate_matrix(Matrice *matrix, int rows, int cols, int width);
+
+/* Libera una matrice allocata con allocate_matrix */
+void free_matrix(Matrice *matrix);
+
+/* Sceglie la larghezza minima (1, 2 o 4 byte) per le distanze L1 tra righe Borda */
+int select_distance_width(int num_projects);
+
+/* Alloca il triangolo superiore delle distanze tra num_rows righe, alla larghezza adatta a num_projects,
+ * se occupa al piu' budget byte; altrimenti lascia dati a NULL */
+void allocate_distance_store(DistanzeTriangolari *distances, int num_rows, int num_projects, size_t budget);
+
+/* Scrive le distanze della riga i verso le colonne first..first + count - 1, con first > i (distances_after[j - first]) */
+void store_distance_segment(DistanzeTriangolari *distances, int i, int first, int count, const int *distances_after);
+
+/* Copia l'intera riga i delle distanze (diagonale compresa) in un vettore di num_righe int */
+void copy_distance_row(const DistanzeTriangolari *distances, int i, int *row);
+
+/* Distanza tra le righe i e j */
+int get_distance(const DistanzeTriangolari *distances, int i, int j);
+
+/* Abilita le huge pages (Transparent Huge Pages) per le matrici grandi, dove disponibili */
+void use_huge_pages(int enabled);
 
 /* Alloca e inizializza un array di puntatori a strutture 'componente' */
 componente **initialize_component_array(int count);
@@ -75,7 +229,7 @@ componente **initialize_component_array(int count);
 /* === Sezione di Deallocazione Completa === */
 
 /* Dealloca tutta la memoria dinamica utilizzata dal programma */
-void free_all_resources(int num_citizens, int num_projects, char **projects_data, cittadino **citizens_data,
-                        contatore **method_counters, vint *borda_matrix, vint *condorcet_matrix, vint *distance_matrix);
+void free_all_resources(int num_projects, char **projects_data, ArchivioCittadini *citizens_data,
+                        ClassiSchede *ballot_classes, contatore **method_counters, Matrice *borda_matrix, Matrice *condorcet_matrix, DistanzeTriangolari *distance_store);
 
 #endif
@@ -0,0 +1,263 @@
+#include "distanza_l1.h"     /* Doxygen++; :) */
+
+#if DISTANZA_L1_SIMD
+#include <immintrin.h>
+#define DISTANZA_L1_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+/* ----------------------------------- Versione portabile ----------------------------------- */
+
+/**
+ * @brief Distanza L1 tra due righe di punteggi da 1 byte.
+ * @param first La prima riga.
+ * @param second La seconda riga.
+ * @param length Numero di elementi.
+ * @return La somma dei valori assoluti delle differenze.
+ */
+static int l1_u8_portable(const unsigned char *first, const unsigned char *second, int length) {
+    int k, total = 0;
+    for (k = 0; k < length; ++k) {
+        total += first[k] > second[k] ? first[k] - second[k] : second[k] - first[k];
+    }
+    return total;
+}
+
+/**
+ * @brief Distanza L1 tra due righe di punteggi da 2 byte.
+ * @param first La prima riga.
+ * @param second La seconda riga.
+ * @param length Numero di elementi.
+ * @return La somma dei valori assoluti delle differenze.
+ */
+static int l1_u16_portable(const unsigned short *first, const unsigned short *second, int length) {
+    int k, total = 0;
+    for (k = 0; k < length; ++k) {
+        total += first[k] > second[k] ? first[k] - second[k] : second[k] - first[k];
+    }
+    return total;
+}
+
+/**
+ * @brief Distanza L1 tra due righe di punteggi int (usata da tutte le famiglie).
+ * @param first La prima riga.
+ * @param second La seconda riga.
+ * @param length Numero di elementi.
+ * @return La somma dei valori assoluti delle differenze.
+ */
+static int l1_i32_portable(const int *first, const int *second, int length) {
+    int k, total = 0;
+    for (k = 0; k < length; ++k) {
+        total += first[k] > second[k] ? first[k] - second[k] : second[k] - first[k];
+    }
+    return total;
+}
+
+#if DISTANZA_L1_SIMD
+/* ------------------------------------------ SSE2 ------------------------------------------ */
+/* Punteggi da 1 byte: PSADBW somma direttamente le differenze assolute di 8 byte in una corsia da 64 bit.
+ * Punteggi da 2 byte: |a - b| = sat(a - b) | sat(b - a), poi estensione a 32 bit e somma. */
+
+/**
+ * @brief Somma le corsie da 64 bit di un accumulatore SSE (i totali stanno nei 32 bit bassi).
+ */
+DISTANZA_L1_TARGET("sse2")
+static int sum_epi64_sse2(__m128i accumulator) {
+    return _mm_cvtsi128_si32(accumulator) + _mm_cvtsi128_si32(_mm_srli_si128(accumulator, 8));
+}
+
+/**
+ * @brief Somma le quattro corsie da 32 bit di un accumulatore SSE.
+ */
+DISTANZA_L1_TARGET("sse2")
+static int sum_epi32_sse2(__m128i accumulator) {
+    accumulator = _mm_add_epi32(accumulator, _mm_srli_si128(accumulator, 8));
+    accumulator = _mm_add_epi32(accumulator, _mm_srli_si128(accumulator, 4));
+    return _mm_cvtsi128_si32(accumulator);
+}
+
+/**
+ * @brief Distanza L1 su punteggi da 1 byte, 16 alla volta (SSE2).
+ */
+DISTANZA_L1_TARGET("sse2")
+static int l1_u8_sse2(const unsigned char *first, const unsigned char *second, int length) {
+    __m128i accumulator = _mm_setzero_si128();
+    int k = 0;
+    for (; k + 16 <= length; k += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(first + k));
+        __m128i b = _mm_loadu_si128((const __m128i *)(second + k));
+        accumulator = _mm_add_epi64(accumulator, _mm_sad_epu8(a, b));
+    }
+    return sum_epi64_sse2(accumulator) + l1_u8_portable(first + k, second + k, length - k);
+}
+
+/**
+ * @brief Distanza L1 su punteggi da 2 byte, 8 alla volta (SSE2).
+ */
+DISTANZA_L1_TARGET("sse2")
+static int l1_u16_sse2(const unsigned short *first, const unsigned short *second, int length) {
+    __m128i accumulator = _mm_setzero_si128();
+    __m128i zero = _mm_setzero_si128();
+    int k = 0;
+    for (; k + 8 <= length; k += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(first + k));
+        __m128i b = _mm_loadu_si128((const __m128i *)(second + k));
+        __m128i difference = _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+        accumulator = _mm_add_epi32(accumulator, _mm_unpacklo_epi16(difference, zero));
+        accumulator = _mm_add_epi32(accumulator, _mm_unpackhi_epi16(difference, zero));
+    }
+    return sum_epi32_sse2(accumulator) + l1_u16_portable(first + k, second + k, length - k);
+}
+
+/* ------------------------------------------ AVX2 ------------------------------------------ */
+
+/**
+ * @brief Distanza L1 su punteggi da 1 byte, 32 alla volta (AVX2); il resto passa a SSE2.
+ */
+DISTANZA_L1_TARGET("avx2")
+static int l1_u8_avx2(const unsigned char *first, const unsigned char *second, int length) {
+    __m256i accumulator = _mm256_setzero_si256();
+    int k = 0, total;
+    for (; k + 32 <= length; k += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(first + k));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(second + k));
+        accumulator = _mm256_add_epi64(accumulator, _mm256_sad_epu8(a, b));
+    }
+    total = sum_epi64_sse2(_mm_add_epi64(_mm256_castsi256_si128(accumulator), _mm256_extracti128_si256(accumulator, 1)));
+    _mm256_zeroupper(); /* Il resto e' codice SSE: evita la penalita' di transizione AVX -> SSE */
+    return total + l1_u8_sse2(first + k, second + k, length - k);
+}
+
+/**
+ * @brief Distanza L1 su punteggi da 2 byte, 16 alla volta (AVX2); il resto passa a SSE2.
+ */
+DISTANZA_L1_TARGET("avx2")
+static int l1_u16_avx2(const unsigned short *first, const unsigned short *second, int length) {
+    __m256i accumulator = _mm256_setzero_si256();
+    __m256i zero = _mm256_setzero_si256();
+    int k = 0, total;
+    for (; k + 16 <= length; k += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(first + k));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(second + k));
+        __m256i difference = _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a));
+        accumulator = _mm256_add_epi32(accumulator, _mm256_unpacklo_epi16(difference, zero));
+        accumulator = _mm256_add_epi32(accumulator, _mm256_unpackhi_epi16(difference, zero));
+    }
+    total = sum_epi32_sse2(_mm_add_epi32(_mm256_castsi256_si128(accumulator), _mm256_extracti128_si256(accumulator, 1)));
+    _mm256_zeroupper();
+    return total + l1_u16_sse2(first + k, second + k, length - k);
+}
+
+/* ---------------------------------------- AVX-512BW ---------------------------------------- */
+
+/**
+ * @brief Distanza L1 su punteggi da 1 byte, 64 alla volta (AVX-512BW); il resto passa ad AVX2.
+ */
+DISTANZA_L1_TARGET("avx512f,avx512bw,avx2")
+static int l1_u8_avx512(const unsigned char *first, const unsigned char *second, int length) {
+    __m512i accumulator = _mm512_setzero_si512();
+    __m256i half;
+    int k = 0;
+    for (; k + 64 <= length; k += 64) {
+        __m512i a = _mm512_loadu_si512((const void *)(first + k));
+        __m512i b = _mm512_loadu_si512((const void *)(second + k));
+        accumulator = _mm512_add_epi64(accumulator, _mm512_sad_epu8(a, b));
+    }
+    half = _mm256_add_epi64(_mm512_castsi512_si256(accumulator), _mm512_extracti64x4_epi64(accumulator, 1));
+    return sum_epi64_sse2(_mm_add_epi64(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1)))
+           + l1_u8_avx2(first + k, second + k, length - k); /* Codice VEX: nessuna transizione */
+}
+
+/**
+ * @brief Distanza L1 su punteggi da 2 byte, 32 alla volta (AVX-512BW); il resto passa ad AVX2.
+ */
+DISTANZA_L1_TARGET("avx512f,avx512bw,avx2")
+static int l1_u16_avx512(const unsigned short *first, const unsigned short *second, int length) {
+    __m512i accumulator = _mm512_setzero_si512();
+    __m512i zero = _mm512_setzero_si512();
+    __m256i half;
+    int k = 0;
+    for (; k + 32 <= length; k += 32) {
+        __m512i a = _mm512_loadu_si512((const void *)(first + k));
+        __m512i b = _mm512_loadu_si512((const void *)(second + k));
+        __m512i difference = _mm512_or_si512(_mm512_subs_epu16(a, b), _mm512_subs_epu16(b, a));
+        accumulator = _mm512_add_epi32(accumulator, _mm512_unpacklo_epi16(difference, zero));
+        accumulator = _mm512_add_epi32(accumulator, _mm512_unpackhi_epi16(difference, zero));
+    }
+    half = _mm256_add_epi32(_mm512_castsi512_si256(accumulator), _mm512_extracti64x4_epi64(accumulator, 1));
+    return sum_epi32_sse2(_mm_add_epi32(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1)))
+           + l1_u16_avx2(first + k, second + k, length - k);
+}
+#endif
+
+/* ---------------------------------------- Selezione ---------------------------------------- */
+
+static const KernelDistanzaL1 kernel_portable = {"portabile", 1, l1_u8_portable, l1_u16_portable, l1_i32_portable};
+#if DISTANZA_L1_SIMD
+static const KernelDistanzaL1 kernel_sse2 = {"sse2", 16, l1_u8_sse2, l1_u16_sse2, l1_i32_portable};
+static const KernelDistanzaL1 kernel_avx2 = {"avx2", 32, l1_u8_avx2, l1_u16_avx2, l1_i32_portable};
+static const KernelDistanzaL1 kernel_avx512 = {"avx512bw", 64, l1_u8_avx512, l1_u16_avx512, l1_i32_portable};
+#endif
+
+static const KernelDistanzaL1 *available_kernels[4];
+static int num_available_kernels = 0;
+
+/**
+ * @brief Elenca, una sola volta, le famiglie di kernel supportate dalla CPU (CPUID, tramite il compilatore).
+ */
+static void detect_l1_kernels(void) {
+    int count = 0;
+    if (num_available_kernels > 0) {
+        return;
+    }
+    available_kernels[count++] = &kernel_portable;
+#if DISTANZA_L1_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        available_kernels[count++] = &kernel_sse2;
+        if (__builtin_cpu_supports("avx2")) {
+            available_kernels[count++] = &kernel_avx2;
+            if (__builtin_cpu_supports("avx512bw")) {
+                available_kernels[count++] = &kernel_avx512;
+            }
+        }
+    }
+#endif
+    num_available_kernels = count;
+}
+
+/**
+ * @brief Numero di famiglie di kernel eseguibili su questa CPU (almeno 1, la portabile).
+ * @return Il numero di kernel disponibili.
+ */
+int count_l1_kernels(void) {
+    detect_l1_kernels();
+    return num_available_kernels;
+}
+
+/**
+ * @brief Restituisce una famiglia di kernel disponibile, dalla portabile (indice 0) alla piu' ampia.
+ * @param index Indice tra 0 e count_l1_kernels() - 1.
+ * @return Il kernel richiesto (la portabile se l'indice non e' valido).
+ */
+const KernelDistanzaL1 *get_l1_kernel(int index) {
+    detect_l1_kernels();
+    if (index < 0 || index >= num_available_kernels) {
+        return &kernel_portable;
+    }
+    return available_kernels[index];
+}
+
+/**
+ * @brief Sceglie la famiglia di kernel piu' adatta a righe di row_bytes byte.
+ * @param row_bytes Byte per riga.
+ * @return Il kernel scelto.
+ */
+const KernelDistanzaL1 *select_l1_kernel(size_t row_bytes) {
+    int index;
+    detect_l1_kernels();
+    index = num_available_kernels - 1;
+    while (index > 1 && (size_t)available_kernels[index]->blocco * DISTANZA_L1_BLOCCHI_MINIMI > row_bytes) {
+        index--;
+    }
+    return available_kernels[index];
+}
@@ -0,0 +1,65 @@
+#ifndef __distanza_l1_h
+#define __distanza_l1_h
+
+#include <stddef.h>
+
+/* Doxygen++; :) */
+
+/*
+ * Kernel vettoriali (SSE2, AVX2, AVX-512BW) per la distanza L1 tra due righe di punteggi Borda, scelti a
+ * runtime in base alla CPU. Richiedono GCC o Clang su x86; compilare con -DDISTANZA_L1_SIMD=0 per usare
+ * soltanto la versione portabile.
+ */
+#ifndef DISTANZA_L1_SIMD
+#if (defined(__GNUC__) && (__GNUC__ >= 6 || defined(__clang__))) && (defined(__x86_64__) || defined(__i386__))
+#define DISTANZA_L1_SIMD 1
+#else
+#define DISTANZA_L1_SIMD 0
+#endif
+#endif
+
+/* Blocchi per riga sotto i quali si preferisce una famiglia di kernel piu' stretta */
+#ifndef DISTANZA_L1_BLOCCHI_MINIMI
+#define DISTANZA_L1_BLOCCHI_MINIMI 4
+#endif
+
+/* Distanza L1 tra due vettori di 'length' elementi, per ciascuna larghezza dei punteggi */
+typedef int (*distanza_l1_u8)(const unsigned char *first, const unsigned char *second, int length);
+typedef int (*distanza_l1_u16)(const unsigned short *first, const unsigned short *second, int length);
+typedef int (*distanza_l1_i32)(const int *first, const int *second, int length);
+
+/**
+ * Un insieme di kernel della stessa famiglia di istruzioni, uno per larghezza.
+ */
+typedef struct {
+    const char *nome;       /* "portabile", "sse2", "avx2" o "avx512bw" */
+    int blocco;             /* Byte elaborati per iterazione: righe lunghe un multiplo di blocco non hanno resto */
+    distanza_l1_u8 u8;
+    distanza_l1_u16 u16;
+    distanza_l1_i32 i32;
+} KernelDistanzaL1;
+
+/**
+ * @brief Numero di famiglie di kernel eseguibili su questa CPU (almeno 1, la portabile).
+ * @return Il numero di kernel disponibili.
+ */
+int count_l1_kernels(void);
+
+/**
+ * @brief Restituisce una famiglia di kernel disponibile, dalla portabile (indice 0) alla piu' ampia.
+ * @param index Indice tra 0 e count_l1_kernels() - 1.
+ * @return Il kernel richiesto.
+ */
+const KernelDistanzaL1 *get_l1_kernel(int index);
+
+/**
+ * @brief Sceglie la famiglia di kernel per righe di row_bytes byte: la piu' ampia supportata dalla CPU il cui
+ * blocco entra almeno DISTANZA_L1_BLOCCHI_MINIMI volte nella riga (su righe corte i registri larghi non
+ * ripagano la riduzione finale), comunque vettoriale se disponibile.
+ * Il rilevamento della CPU avviene alla prima chiamata: conviene eseguirla prima di avviare i thread.
+ * @param row_bytes Byte per riga.
+ * @return Il kernel scelto.
+ */
+const KernelDistanzaL1 *select_l1_kernel(size_t row_bytes);
+
+#endif /* __distanza_l1_h */
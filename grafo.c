@@ -4,80 +4,92 @@
 
 void creagrafo (int n, grafo *pG)
 {
-  nodo o;
-
   pG->n = n;
   pG->m = 0;
-  pG->FS = (listaarchi *) calloc(pG->n,sizeof(listaarchi));
+  pG->FS = (posarcoFS *) calloc(pG->n+1,sizeof(posarcoFS));
+  pG->dest = NULL;
   if (pG->FS == NULL)
   {
     fprintf(stderr,"Errore nell'allocazione del vettore delle forward star!\n");
     exit(EXIT_FAILURE);
   }
-
-  for (o = 0; o < pG->n; o++)
-    pG->FS[o] = crealistaarchi();
 }
 
-void distruggegrafo (grafo *pG)
-{
-  nodo o;
-
-  for (o = 0; o < pG->n; o++)
-    distruggelistaarchi(&pG->FS[o]);
-  free(pG->FS);
-
-  pG->n = 0;
-  pG->m = 0;
-}
-void insarco (nodo o, nodo d, grafo *pG)
+void creagrafoCondorcet (const Matrice *M, int n, grafo *pG)
 {
-  posarco pa, q;
-  nodo orig, dest;
-
-  for (pa = primolistaarchi(pG->FS[o]); !finelistaarchi(pG->FS[o],pa); pa = succlistaarchi(pG->FS[o],pa))
+  nodo o, d;
+  size_t capacita;
+
+  creagrafo(n,pG);
+  /* Ogni coppia da' almeno un arco: si parte da n(n-1)/2 posti e si cresce solo se ci sono molti pareggi.
+     Le forward star si scrivono in fila, senza una passata preliminare per contare i gradi. */
+  capacita = (size_t)n*(n > 1 ? n-1 : 0)/2 + n + 1;
+  pG->dest = (nodo *) malloc(capacita*sizeof(nodo));
+  if (pG->dest == NULL)
   {
-    leggearco(pG->FS[o],pa,&orig,&dest);
-    if ( (o == orig) && (d == dest) )
-        break;
+    fprintf(stderr,"Errore nell'allocazione del vettore degli archi!\n");
+    exit(EXIT_FAILURE);
   }
 
-  if (finelistaarchi(pG->FS[o],pa))
+  for (o = 0; o < n; o++)
   {
-    q = succlistaarchi(pG->FS[o],ultimolistaarchi(pG->FS[o]));
-    inslistaarchi(pG->FS[o],q,o,d);
-    pG->m++;
+    const int *riga = MATRICE_INT(M,o);
+    pG->FS[o] = pG->m;
+    if ((size_t)pG->m + n > capacita) /* La forward star di o potrebbe non entrare */
+    {
+      capacita += capacita/2 + n;
+      pG->dest = (nodo *) realloc(pG->dest,capacita*sizeof(nodo));
+      if (pG->dest == NULL)
+      {
+        fprintf(stderr,"Errore nell'allocazione del vettore degli archi!\n");
+        exit(EXIT_FAILURE);
+      }
+    }
+    for (d = 0; d < n; d++)
+      if ( (d != o) && (riga[d] >= MATRICE_INT(M,d)[o]) ) /* o vince su d, o pareggia */
+        pG->dest[pG->m++] = d;
   }
+  pG->FS[n] = pG->m;
 }
 
-posarco primoarcoFS (grafo *pG, nodo o)
+void distruggegrafo (grafo *pG)
 {
-  return primolistaarchi(pG->FS[o]);
+  free(pG->FS);
+  free(pG->dest);
+  pG->FS = NULL;
+  pG->dest = NULL;
+
+  pG->n = 0;
+  pG->m = 0;
 }
 
-posarco succarcoFS (grafo *pG, nodo o, posarco pa)
+posarcoFS primoarcoFS (grafo *pG, nodo o)
 {
-  return succlistaarchi(pG->FS[o],pa);
+  return pG->FS[o];
 }
 
-boolean finearchiFS (grafo *pG, nodo o, posarco pa)
+posarcoFS succarcoFS (grafo *pG, nodo o, posarcoFS pa)
 {
-  return finelistaarchi(pG->FS[o],pa);
+  (void)pG;
+  (void)o;
+  return pa+1;
 }
 
-nodo leggedestarco (grafo *pG, nodo o, posarco pa)
+boolean finearchiFS (grafo *pG, nodo o, posarcoFS pa)
 {
-  int orig, d;
+  return (pa == pG->FS[o+1]);
+}
 
-  leggearco(pG->FS[o],pa,&orig,&d);
-  
-  return d;
+nodo leggedestarco (grafo *pG, nodo o, posarcoFS pa)
+{
+  (void)o;
+  return pG->dest[pa];
 }
 
 void DFSricorsiva (grafo *pG, nodo s, vint C, int c)
 {
   nodo w;
-  posarco pa;
+  posarcoFS pa;
   C[s] = c;
 
   for (pa = primoarcoFS(pG,s); !finearchiFS(pG,s,pa); pa = succarcoFS(pG,s,pa))
@@ -90,19 +102,33 @@ void DFSricorsiva (grafo *pG, nodo s, vint C, int c)
 
 void CostruisceGrafoTrasposto (grafo *pG, grafo *pGT)
 {
-  nodo o, d;
-  posarco pa;
+  nodo o;
+  posarcoFS pa, *prossimo;
 
   creagrafo(pG->n,pGT);
+  pGT->m = pG->m;
+  pGT->dest = (nodo *) malloc((pG->m > 0 ? pG->m : 1)*sizeof(nodo));
+  prossimo = (posarcoFS *) malloc((pG->n > 0 ? pG->n : 1)*sizeof(posarcoFS));
+  if ( (pGT->dest == NULL) || (prossimo == NULL) )
+  {
+    fprintf(stderr,"Errore nell'allocazione del grafo trasposto!\n");
+    exit(EXIT_FAILURE);
+  }
 
+  /* Grado entrante di ogni nodo, poi le posizioni di inizio delle forward star del trasposto */
+  for (pa = 0; pa < pG->m; pa++)
+    pGT->FS[pG->dest[pa]+1]++;
   for (o = 0; o < pG->n; o++)
   {
-    for (pa = primoarcoFS(pG,o); !finearchiFS(pG,o,pa); pa = succarcoFS(pG,o,pa))
-    {
-      d = leggedestarco(pG,o,pa);
-      insarco(d,o,pGT);
-    }
+    pGT->FS[o+1] += pGT->FS[o];
+    prossimo[o] = pGT->FS[o];
   }
+
+  /* Origini in ordine crescente: ogni forward star del trasposto resta ordinata */
+  for (o = 0; o < pG->n; o++)
+    for (pa = primoarcoFS(pG,o); !finearchiFS(pG,o,pa); pa = succarcoFS(pG,o,pa))
+      pGT->dest[prossimo[leggedestarco(pG,o,pa)]++] = o;
+  free(prossimo);
 }
 
 void Intersezione (vint U1, vint U2, contatore **C, int n)
@@ -116,44 +142,79 @@ void Intersezione (vint U1, vint U2, contatore **C, int n)
 
 void ComponentiFortementeConnesse (grafo *pG, contatore **C, int *pnc)
 {
-  nodo s, v;
-  vint U1, U2;
-  grafo GT;
-
-  U1 = (vint) calloc(pG->n+1,sizeof(int));
-  if (U1 == NULL)
+  nodo s, v, w;
+  int n = pG->n, visitati = 0, cima = 0, profondita = 0, nc = 0;
+  vint blocco, indice, minimo, pila, chiamate, componente;
+  posarcoFS *prossimo;
+
+  /* Un solo blocco per i vettori di lavoro, azzerato una volta sola */
+  blocco = (vint) calloc(6*((size_t)n+1),sizeof(int));
+  if (blocco == NULL)
   {
-    fprintf(stderr,"Errore nell'allocazione del vettore U1!\n");
+    fprintf(stderr,"Errore nell'allocazione dei vettori per le componenti fortemente connesse!\n");
     exit(EXIT_FAILURE);
   }
-
-  U2 = (vint) calloc(pG->n+1,sizeof(int));
-  if (U2 == NULL)
+  indice = blocco;                 /* Ordine di scoperta + 1, 0 se non ancora visitato */
+  minimo = indice + (n+1);         /* Minimo indice raggiungibile restando nella pila (lowlink) */
+  pila = minimo + (n+1);           /* Nodi visitati la cui componente non e' ancora chiusa */
+  chiamate = pila + (n+1);         /* Pila esplicita della visita in profondita' */
+  componente = chiamate + (n+1);   /* Componente assegnata, 0 finche' il nodo e' nella pila */
+  prossimo = (posarcoFS *) (componente + (n+1)); /* Prossimo arco da esplorare per ogni nodo */
+
+  /* Tarjan iterativo: una sola visita, senza grafo trasposto */
+  for (s = 0; s < n; s++)
   {
-    fprintf(stderr,"Errore nell'allocazione del vettore U2!\n");
-    exit(EXIT_FAILURE);
+    if (indice[s] != 0)
+      continue;
+    indice[s] = minimo[s] = ++visitati;
+    pila[cima++] = s;
+    prossimo[s] = primoarcoFS(pG,s);
+    chiamate[profondita++] = s;
+
+    while (profondita > 0)
+    {
+      v = chiamate[profondita-1];
+      if (!finearchiFS(pG,v,prossimo[v]))
+      {
+        w = leggedestarco(pG,v,prossimo[v]);
+        prossimo[v] = succarcoFS(pG,v,prossimo[v]);
+        if (indice[w] == 0)
+        {
+          indice[w] = minimo[w] = ++visitati;
+          pila[cima++] = w;
+          prossimo[w] = primoarcoFS(pG,w);
+          chiamate[profondita++] = w;
+        }
+        else if ( (componente[w] == 0) && (indice[w] < minimo[v]) )
+          minimo[v] = indice[w];
+      }
+      else
+      {
+        profondita--;
+        if (minimo[v] == indice[v]) /* v e' la radice di una componente: la si toglie dalla pila */
+        {
+          nc++;
+          do
+          {
+            w = pila[--cima];
+            componente[w] = nc;
+          } while (w != v);
+        }
+        if ( (profondita > 0) && (minimo[v] < minimo[chiamate[profondita-1]]) )
+          minimo[chiamate[profondita-1]] = minimo[v];
+      }
+    }
   }
 
-  CostruisceGrafoTrasposto(pG,&GT);
-
+  /* Numera le componenti nell'ordine del loro nodo minimo, come la versione con le visite ripetute */
+  for (v = 0; v <= nc; v++)
+    indice[v] = 0;
   *pnc = 0;
-  for (s = 0; s < pG->n; s++)
-    if ((*C[s]).cont == 0)
-    {
-      (*pnc)++;
-
-      for (v = 0; v < pG->n; v++)
-        U1[v] = 0;
-      DFSricorsiva(pG,s,U1,*pnc);
-
-      for (v = 0; v < pG->n; v++)
-        U2[v] = 0;
-      DFSricorsiva(&GT,s,U2,*pnc);
-
-      Intersezione(U1,U2,C,pG->n);
-    }
-  free(U1);
-  free(U2);
-  distruggegrafo(&GT);
+  for (v = 0; v < n; v++)
+  {
+    if (indice[componente[v]] == 0)
+      indice[componente[v]] = ++(*pnc);
+    (*C[v]).cont = indice[componente[v]];
+  }
+  free(blocco);
 }
-
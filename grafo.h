@@ -23,14 +23,22 @@
 
 
 /**
- * @brief Struttura che rappresenta un grafo.
+ * @brief Posizione di un arco nel vettore delle destinazioni del grafo.
+ */
+typedef int posarcoFS;
+
+/**
+ * @brief Struttura che rappresenta un grafo in formato CSR (compressed sparse row):
+ * le forward star di tutti i nodi sono tratti consecutivi di un unico vettore di destinazioni.
  *
  * @var grafo::n
  * Numero di nodi nel grafo.
  * @var grafo::m
  * Numero di archi nel grafo.
  * @var grafo::FS
- * Array di liste di adiacenza (forward stars) per ciascun nodo.
+ * Vettore di n + 1 posizioni: la forward star del nodo o sono gli archi da FS[o] a FS[o+1] - 1.
+ * @var grafo::dest
+ * Vettore delle m destinazioni, raggruppate per nodo di origine.
  */
 typedef struct _grafo grafo;
 
@@ -38,7 +46,8 @@ struct _grafo
 {
   int n;
   int m;
-  listaarchi *FS;
+  posarcoFS *FS;
+  nodo *dest;
 };
 
 
@@ -62,20 +71,22 @@ void creagrafo (int n, grafo *pG);
 void distruggegrafo (grafo *pG);
 
 /**
- * @brief Aggiunge un arco diretto dal nodo 'o' al nodo 'd' nel grafo.
- * Non esegue alcuna operazione se l'arco esiste gi.
+ * @brief Crea il grafo del torneo di Condorcet in un'unica passata sulla matrice dei confronti:
+ * c'e' l'arco (o,d) se o batte d o pareggia con d (un pareggio da' gli archi in entrambe le direzioni).
+ * Le forward star vengono scritte una dopo l'altra, con le destinazioni in ordine crescente.
  *
- * @param o Il nodo di origine dell'arco.
- * @param d Il nodo di destinazione dell'arco.
- * @param pG Puntatore alla struttura grafo in cui inserire l'arco.
+ * @param M Matrice di Condorcet (n x n): M[o][d] e' il numero di elettori che preferiscono o a d.
+ * @param n Il numero di nodi (progetti).
+ * @param pG Puntatore alla struttura grafo da inizializzare.
  */
-void insarco (int o, int d, grafo *pG);
+void creagrafoCondorcet (const Matrice *M, int n, grafo *pG);
 
 
 
 /* Le seguenti funzioni sono commentate nel codice originale,
    ma ho incluso i loro prototipi con commenti Doxygen
-   nel caso volessi riattivarle in futuro. */
+   nel caso volessi riattivarle in futuro (su un grafo CSR
+   andrebbero riscritte come costruzione di un nuovo grafo). */
 
 /**
  * @brief Cancella l'arco (o,d) dal grafo *pG.
@@ -104,7 +115,7 @@ void insarco (int o, int d, grafo *pG);
  * @param o Il nodo di cui si vuole ottenere la forward star.
  * @return La posizione del primo arco nella forward star.
  */
-posarco primoarcoFS (grafo *pG, nodo o);
+posarcoFS primoarcoFS (grafo *pG, nodo o);
 
 /**
  * @brief Restituisce la posizione dell'arco successivo a 'pa' nella forward star del nodo 'o'.
@@ -114,7 +125,7 @@ posarco primoarcoFS (grafo *pG, nodo o);
  * @param pa La posizione corrente dell'arco.
  * @return La posizione dell'arco successivo.
  */
-posarco succarcoFS (grafo *pG, nodo o, posarco pa);
+posarcoFS succarcoFS (grafo *pG, nodo o, posarcoFS pa);
 
 /**
  * @brief Determina se la posizione 'pa'  al di fuori della forward star del nodo 'o'.
@@ -124,7 +135,7 @@ posarco succarcoFS (grafo *pG, nodo o, posarco pa);
  * @param pa La posizione corrente dell'arco.
  * @return TRUE se la posizione  la fine della lista, FALSE altrimenti.
  */
-boolean finearchiFS (grafo *pG, nodo o, posarco pa);
+boolean finearchiFS (grafo *pG, nodo o, posarcoFS pa);
 
 /**
  * @brief Restituisce il nodo di destinazione dell'arco in posizione 'pa' nella forward star del nodo 'o'.
@@ -134,7 +145,7 @@ boolean finearchiFS (grafo *pG, nodo o, posarco pa);
  * @param pa La posizione dell'arco.
  * @return Il nodo di destinazione dell'arco.
  */
-nodo leggedestarco (grafo *pG, nodo o, posarco pa);
+nodo leggedestarco (grafo *pG, nodo o, posarcoFS pa);
 
 
 /**
@@ -150,7 +161,8 @@ void DFSricorsiva (grafo *pG, nodo s, vint C, int c);
 
 /**
  * @brief Costruisce il grafo trasposto 'pGT' a partire dal grafo originale 'pG'.
- * Il grafo trasposto ha gli stessi nodi ma tutti gli archi sono invertiti.
+ * Il grafo trasposto ha gli stessi nodi ma tutti gli archi sono invertiti; si costruisce in O(n + m)
+ * contando i gradi entranti e distribuendo gli archi, con le destinazioni ancora in ordine crescente.
  *
  * @param pG Puntatore al grafo originale.
  * @param pGT Puntatore alla struttura grafo che verr inizializzata come trasposto.
@@ -172,6 +184,8 @@ void Intersezione (vint U1, vint U2, contatore **C, int n);
  * @brief Determina le componenti fortemente connesse del grafo 'pG'.
  * Il risultato viene memorizzato nel vettore 'C', e il numero totale di componenti
  * connesse viene memorizzato in 'pnc'.
+ * Algoritmo di Tarjan iterativo, con una pila esplicita al posto della ricorsione: una sola visita in
+ * O(n + m), senza grafo trasposto. Le componenti sono numerate da 1 nell'ordine del loro nodo minimo.
  *
  * @param pG Puntatore al grafo su cui calcolare le componenti.
  * @param C Vettore di puntatori a strutture contatore dove verranno memorizzati i risultati delle componenti.
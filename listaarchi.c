@@ -2,15 +2,107 @@
 
 
 
-listaarchi crealistaarchi ()
+typedef struct _bloccoarchi bloccoarchi;
+
+struct _bloccoarchi
+{
+  bloccoarchi *succ;
+  arco archi[ARCHI_PER_BLOCCO];
+};
+
+struct _poolarchi
+{
+  bloccoarchi *blocchi; /* Blocchi allocati, il piu' recente in testa */
+  int usati;            /* Archi gia' consegnati dal blocco in testa */
+  posarco liberi;       /* Archi restituiti, collegati tramite succ */
+};
+
+/* La sentinella di ogni lista e' il primo campo della testa, che ricorda da quale pool vengono gli archi */
+typedef struct
+{
+  arco sentinella;
+  poolarchi *pool;
+  boolean proprio;      /* TRUE se il pool e' stato creato per questa sola lista */
+} testalista;
+
+
+static posarco prendearco (poolarchi *P)
+{
+  posarco q;
+
+  if (P->liberi != NULL)
+  {
+    q = P->liberi;
+    P->liberi = q->succ;
+    return q;
+  }
+
+  if ( (P->blocchi == NULL) || (P->usati == ARCHI_PER_BLOCCO) )
+  {
+    bloccoarchi *B = (bloccoarchi *) malloc(sizeof(bloccoarchi));
+    if (B == NULL)
+    {
+      fprintf(stderr,"Memoria insufficiente per allocare un arco!\n");
+      exit(EXIT_FAILURE);
+    }
+    B->succ = P->blocchi;
+    P->blocchi = B;
+    P->usati = 0;
+  }
+
+  return &P->blocchi->archi[P->usati++];
+}
+
+static void restituiscearco (poolarchi *P, posarco p)
+{
+  p->succ = P->liberi;
+  P->liberi = p;
+}
+
+poolarchi *creapoolarchi ()
+{
+  poolarchi *P = (poolarchi *) malloc(sizeof(poolarchi));
+  if (P == NULL)
+  {
+    fprintf(stderr,"Memoria insufficiente per allocare un pool di archi!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  P->blocchi = NULL;
+  P->usati = 0;
+  P->liberi = NULL;
+
+  return P;
+}
+
+void distruggepoolarchi (poolarchi **pP)
+{
+  bloccoarchi *B;
+
+  while ((*pP)->blocchi != NULL)
+  {
+    B = (*pP)->blocchi;
+    (*pP)->blocchi = B->succ;
+    free(B);
+  }
+  free(*pP);
+  *pP = NULL;
+}
+
+listaarchi crealistaarchipool (poolarchi *P)
 {
-  listaarchi L = (listaarchi) malloc(sizeof(arco));
-  if (L == NULL)
+  testalista *T = (testalista *) malloc(sizeof(testalista));
+  listaarchi L;
+  if (T == NULL)
   {
     fprintf(stderr,"Memoria insufficiente per allocare un arco!\n");
     exit(EXIT_FAILURE);
   }
 
+  T->pool = P;
+  T->proprio = FALSE;
+
+  L = &T->sentinella;
   L->orig = 0;
   L->dest = 0;
 
@@ -20,16 +112,28 @@ listaarchi crealistaarchi ()
   return L;
 }
 
+listaarchi crealistaarchi ()
+{
+  listaarchi L = crealistaarchipool(creapoolarchi());
+
+  ((testalista *) L)->proprio = TRUE;
+
+  return L;
+}
+
 void distruggelistaarchi (listaarchi *pL)
 {
-  posarco p;
+  testalista *T = (testalista *) *pL;
 
-  while (!listaarchivuota(*pL))
+  if (T->proprio)
+    distruggepoolarchi(&T->pool);
+  else if (!listaarchivuota(*pL))
   {
-    p = primolistaarchi(*pL);
-    *pL = canclistaarchi(*pL,&p);
+    /* La catena degli archi, dal primo all'ultimo, passa intera in testa agli archi liberi */
+    (*pL)->pred->succ = T->pool->liberi;
+    T->pool->liberi = (*pL)->succ;
   }
-  free(*pL);
+  free(T);
   *pL = NULL;
 }
 
@@ -79,12 +183,7 @@ boolean finelistaarchi (listaarchi L, posarco p)
 
 listaarchi inslistaarchi (listaarchi L, posarco p, int orig, int dest)
 {
-  posarco q = (posarco) malloc(sizeof(arco));
-  if (q == NULL)
-  {
-    fprintf(stderr,"Memoria insufficiente per allocare un arco!\n");
-    exit(EXIT_FAILURE);
-  }
+  posarco q = prendearco(((testalista *) L)->pool);
   
   q->orig = orig;
   q->dest = dest;
@@ -103,7 +202,7 @@ listaarchi canclistaarchi (listaarchi L, posarco *pp)
   *pp = p->succ;
   p->pred->succ = p->succ;
   p->succ->pred = p->pred;
-  free(p);
+  restituiscearco(((testalista *) L)->pool,p);
 
   return L;
 }
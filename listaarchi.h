@@ -11,12 +11,20 @@
 #define NO_ARC   NULL
 #define NO_NODE     0
 
+/* Archi per blocco del pool: gli archi si allocano a blocchi contigui invece che uno alla volta */
+#ifndef ARCHI_PER_BLOCCO
+#define ARCHI_PER_BLOCCO 256
+#endif
+
 
 typedef struct _arco arco;
 typedef arco* listaarchi;
 typedef arco* posarco;
 typedef int nodo;
 
+/* Pool di archi (struttura opaca, definita in listaarchi.c): blocchi contigui e una lista degli archi liberi */
+typedef struct _poolarchi poolarchi;
+
 struct _arco
 {
   nodo    orig, dest;
@@ -24,8 +32,19 @@ struct _arco
 };
 
 
+/* Crea un pool vuoto, da condividere tra piu' liste (ad esempio le forward star di un grafo) */
+poolarchi *creapoolarchi ();
+
+/* Libera tutti i blocchi del pool in O(blocchi); le liste create nel pool non vanno piu' usate */
+void distruggepoolarchi (poolarchi **pP);
+
+/* Crea una lista con un pool proprio, liberato da distruggelistaarchi */
 listaarchi crealistaarchi ();
 
+/* Crea una lista i cui archi vengono dal pool P */
+listaarchi crealistaarchipool (poolarchi *P);
+
+/* Distrugge la lista: gli archi tornano al pool in O(1), o il pool proprio viene liberato */
 void distruggelistaarchi (listaarchi *pL);
 
 void leggearco (listaarchi L, posarco p, nodo *porig, nodo *pdest);
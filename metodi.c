@@ -2,6 +2,138 @@
 #include "sort.h"
 #include "grafo.h"      /* Contiene le funzioni relative al grafo per Condorcet */
 #include "metodi.h"		/* Doxygen++; :) */
+#include "parallelo.h"
+#include "distanza_l1.h"
+
+/* Schede elaborate insieme dal kernel Condorcet: ogni riga della matrice viene aggiornata per tutto il blocco */
+#ifndef CONDORCET_BLOCCO
+#define CONDORCET_BLOCCO 16
+#endif
+
+/* Numero minimo di schede per thread nella raccolta dei dati: sotto questa soglia i thread non convengono */
+#ifndef AGGREGAZIONE_SCHEDE_PER_THREAD
+#define AGGREGAZIONE_SCHEDE_PER_THREAD 256
+#endif
+
+/* Byte di righe Borda per blocco del calcolo delle distanze: i due blocchi di una tessera stanno in cache L2 */
+#ifndef DISTANZE_BLOCCO_BYTE
+#define DISTANZE_BLOCCO_BYTE (1UL << 17)
+#endif
+
+/* Righe minime per blocco: sotto, il costo di prelievo delle tessere supera il lavoro */
+#ifndef DISTANZE_BLOCCO_MIN_RIGHE
+#define DISTANZE_BLOCCO_MIN_RIGHE 16
+#endif
+
+/* Campioni estratti dal clustering a campionamento (CLARA): si tengono i medoidi del campione migliore */
+#ifndef CLARA_CAMPIONI
+#define CLARA_CAMPIONI 5
+#endif
+
+/* Scambi casuali consecutivi senza miglioramento dopo i quali la ricerca locale (CLARANS) si ferma */
+#ifndef CLARANS_VICINI
+#define CLARANS_VICINI 250
+#endif
+
+/**
+ * @brief Dati condivisi dai thread della raccolta dati: ciascun thread elabora un intervallo contiguo di
+ * schede con contatori di pluralita' e matrice Condorcet propri (il thread 0 usa direttamente quelli finali).
+ */
+typedef struct {
+    cittadino **ballots;
+    const int *weights;
+    int num_ballots;
+    int num_projects;
+    contatore ***counters;      /* Contatori di pluralita' di ciascun thread */
+    Matrice *condorcet;         /* Matrice Condorcet di ciascun thread */
+    Matrice *borda;     /* Condivisa: ogni scheda scrive solo la propria riga */
+} LavoroAggregazione;
+
+static void aggregate_ballot_range(void *context, int worker, int num_workers);
+
+/**
+ * @brief Dati condivisi dal calcolo a tessere delle distanze. Il triangolo delle coppie (i, j), i < j, e' diviso
+ * in tessere di blocco_righe x blocco_righe: la tessera (I, J), con I <= J, confronta le righe del blocco I con
+ * quelle del blocco J, che restano in cache per tutta la tessera. Le tessere sulla diagonale sono meta' delle
+ * altre, quindi vengono distribuite dinamicamente.
+ */
+typedef struct {
+    const Matrice *borda;
+    DistanzeTriangolari *distances;
+    int num_rows;
+    int num_projects;
+    int blocco_righe;
+    int *tessera_riga;      /* Blocco di righe I di ciascuna tessera */
+    int *tessera_colonna;   /* Blocco di colonne J di ciascuna tessera */
+    int **buffers;          /* Una riga di blocco_righe distanze per thread */
+} LavoroDistanze;
+
+static void distance_tile(void *context, int task, int worker);
+
+/**
+ * @brief Candidato del greedy pigro (CELF): il guadagno e' quello calcolato al turno 'turno'. Poiche' il guadagno
+ * di una classe non cresce mai aggiungendo rappresentanti (la funzione obiettivo e' submodulare), un valore
+ * calcolato in un turno precedente e' un limite superiore di quello attuale.
+ */
+typedef struct {
+    long guadagno;      /* Riduzione della somma pesata delle distanze minime se la classe diventa rappresentante */
+    int classe;
+    int turno;
+} CandidatoCELF;
+
+/**
+ * @brief Coda di priorita' (heap binario) dei candidati: guadagno maggiore prima, a parita' la regola del clustering.
+ */
+typedef struct {
+    CandidatoCELF *voci;
+    int dimensione;
+    const int *rappresentante;  /* Cittadino rappresentante di ciascuna classe, per la regola di parita' */
+    cittadino **citizens_data;
+} CodaCELF;
+
+static void celf_sift_down(CodaCELF *queue, int position);
+static long celf_gain(const int *distance_row, componente **class_components, const int *weight, int num_classes);
+
+/* Kernel specializzati per larghezza degli indici e dei punteggi (vedi metodi_kernel.h) */
+#define RANK_T unsigned char
+#define KERNEL(nome) nome##_u8
+#define KERNEL_L1 u8
+#include "metodi_kernel.h"
+#undef RANK_T
+#undef KERNEL
+#undef KERNEL_L1
+
+#define RANK_T unsigned short
+#define KERNEL(nome) nome##_u16
+#define KERNEL_L1 u16
+#include "metodi_kernel.h"
+#undef RANK_T
+#undef KERNEL
+#undef KERNEL_L1
+
+#define RANK_T int
+#define KERNEL(nome) nome##_i32
+#define KERNEL_L1 i32
+#include "metodi_kernel.h"
+#undef RANK_T
+#undef KERNEL
+#undef KERNEL_L1
+
+static int precedes_on_tie(int first, int second, cittadino **citizens_data);
+static unsigned long next_random(unsigned long *state);
+static int class_distance(const Matrice *borda_matrix, int first, int second, int num_projects);
+static int build_sample_medoids(const int *sample_distances, const int *sample_weight, const int *sample_classes, int sample_count,
+                                int desired_groups, const ClassiSchede *ballot_classes, cittadino **citizens_data, int *medoids);
+static long sample_cost(const int *sample_distances, const int *sample_weight, int sample_count, const int *medoids, int num_medoids);
+static long assign_to_medoids(const Matrice *borda_matrix, const ClassiSchede *ballot_classes, const int *medoids, int num_medoids,
+                              int num_projects, cittadino **citizens_data, componente **class_components, StatistichePotatura *stats);
+static int pair_distance(const Matrice *borda_matrix, const DistanzeTriangolari *distance_store, int first, int second, int num_projects);
+static void print_class_assignment(const ClassiSchede *ballot_classes, componente **class_components, int num_citizens, int num_groups, cittadino **citizens_data);
+static void record_greedy_round(const ClassiSchede *ballot_classes, componente **class_components, int num_citizens, int num_groups,
+                                const char *print_at, cittadino **citizens_data, long *group_costs);
+static void compute_distance_row(const Matrice *borda_matrix, int i, int first, int num_rows, int num_projects, int *distances);
+static void fill_distance_store(const Matrice *borda_matrix, DistanzeTriangolari *distance_store, int num_rows, int num_projects, int num_workers);
+static void load_distance_row(const Matrice *borda_matrix, const DistanzeTriangolari *distance_store, int i, int num_projects, int *row);
 
 /* ------------------------------Procedure sui dati preparati------------------------------ */
 /* ----------------------------Garantisce modifiche pi semplici--------------------------- */
@@ -19,24 +151,42 @@ void calculate_and_display_plurality(contatore **counters, vchar *project_names,
 
 /*
  * @brief Calcola i punteggi del metodo Borda e stampa i risultati.
- * @param borda_matrix Matrice dei punteggi Borda per cittadino.
+ * @param borda_matrix Matrice dei punteggi Borda per classe di schede.
+ * @param weights Numero di cittadini di ciascuna classe (riga della matrice).
  * @param counters Array di contatori per i progetti.
  * @param project_names Array dei nomi dei progetti.
- * @param num_citizens Numero di abitanti.
+ * @param num_rows Numero di righe della matrice (classi di schede).
  * @param num_projects Numero di progetti.
  */
-void calculate_and_display_borda(vint *borda_matrix, contatore **counters, vchar *project_names, int num_citizens, int num_projects) {
-	    int i,j;
+void calculate_and_display_borda(const Matrice *borda_matrix, const int *weights, contatore **counters, vchar *project_names, int num_rows, int num_projects) {
     reset_project_counters(counters, num_projects); /* Resetta i contatori prima di accumulare i punteggi */
-    for (j = 0; j < num_projects; ++j) {
-        for (i = 0; i < num_citizens; ++i) {
-            counters[j]->cont += borda_matrix[i][j]; /* Somma i punteggi Borda per ciascun progetto */
-        }
+    switch (borda_matrix->larghezza) {
+        case 1: borda_column_sums_u8(borda_matrix, weights, counters, num_rows, num_projects); break;
+        case 2: borda_column_sums_u16(borda_matrix, weights, counters, num_rows, num_projects); break;
+        default: borda_column_sums_i32(borda_matrix, weights, counters, num_rows, num_projects); break;
     }
     qsort_punt_lescg(counters, 0, num_projects - 1, 0); /* Ordina i risultati finali di Borda */
 
     display_method_results(counters, project_names, num_projects, 1);
 }
+/*
+ * @brief Stampa i risultati del metodo Borda a partire dai punteggi totali gia' accumulati.
+ * @param borda_totals Punteggio Borda totale di ciascun progetto.
+ * @param counters Array di contatori per i progetti.
+ * @param project_names Array dei nomi dei progetti.
+ * @param num_projects Numero di progetti.
+ */
+void calculate_and_display_borda_totals(vint borda_totals, contatore **counters, vchar *project_names, int num_projects) {
+    int j;
+    reset_project_counters(counters, num_projects);
+    for (j = 0; j < num_projects; ++j) {
+        counters[j]->cont = borda_totals[j];
+    }
+    qsort_punt_lescg(counters, 0, num_projects - 1, 0); /* Stesso ordinamento della versione con matrice */
+
+    display_method_results(counters, project_names, num_projects, 1);
+}
+
 /*
  * @brief Calcola i risultati del metodo Condorcet e stampa il vincitore/ordine.
  * @param condorcet_matrix Matrice di confronto Condorcet.
@@ -44,24 +194,11 @@ void calculate_and_display_borda(vint *borda_matrix, contatore **counters, vchar
  * @param project_names Array dei nomi dei progetti.
  * @param num_projects Numero di progetti.
  */
-void calculate_and_display_condorcet(vint *condorcet_matrix, contatore **counters, vchar *project_names, int num_projects) {
+void calculate_and_display_condorcet(const Matrice *condorcet_matrix, contatore **counters, vchar *project_names, int num_projects) {
     grafo condorcet_graph; /* Istanza del grafo per Condorcet */
-    int i,j;
     int num_connected_components = 0;
-    /* Inizializzazione del grafo */
-    creagrafo(num_projects, &condorcet_graph);
-    for (i = 0; i < num_projects - 1; ++i) {
-        for (j = i + 1; j < num_projects; ++j) {
-            if (condorcet_matrix[i][j] > condorcet_matrix[j][i]) {
-                insarco(i, j, &condorcet_graph); /* i "vince" su j */
-            } else if (condorcet_matrix[i][j] == condorcet_matrix[j][i]) {
-                insarco(i, j, &condorcet_graph); /* Parit: arco in entrambe le direzioni */
-                insarco(j, i, &condorcet_graph);
-            } else {
-                insarco(j, i, &condorcet_graph);
-            }
-        }
-    }
+    /* Inizializzazione del grafo: i "vince" su j se e' preferito da piu' elettori; la parita' da' gli archi in entrambe le direzioni */
+    creagrafoCondorcet(condorcet_matrix, num_projects, &condorcet_graph);
 
     reset_project_counters(counters, num_projects); /* Resetta i contatori per l'uso con le componenti connesse */
 
@@ -79,135 +216,849 @@ void calculate_and_display_condorcet(vint *condorcet_matrix, contatore **counter
 
 /*
  * @brief Esegue l'algoritmo di clustering greedy e stampa i gruppi risultanti.
- * @param borda_scores_matrix Matrice dei punteggi Borda (usata per calcolare le distanze).
- * @param distance_matrix Matrice delle distanze tra i cittadini.
+ * E' il caso particolare di perform_greedy_sweep che si ferma a desired_groups e stampa solo l'ultimo raggruppamento.
+ * @param borda_scores_matrix Matrice dei punteggi Borda per classe (usata per calcolare le distanze).
+ * @param distance_store Distanze tra le classi (triangolo superiore), riempite qui; senza dati si ricalcolano al volo.
+ * @param ballot_classes Classi di schede identiche.
+ * @param num_citizens Numero di abitanti.
+ * @param num_projects Numero di progetti.
+ * @param desired_groups Numero di gruppi desiderati (almeno 1, verificato alla lettura dei parametri).
+ * @param citizens_data Array di strutture cittadino.
+ * @param num_workers Numero massimo di thread per il calcolo delle distanze (1 = seriale).
+ * @param stats Se non NULL, vi si sommano le distanze valutate ed evitate nell'aggiornamento delle assegnazioni.
+ */
+void perform_greedy_clustering(const Matrice *borda_scores_matrix, DistanzeTriangolari *distance_store, const ClassiSchede *ballot_classes, int num_citizens, int num_projects, int desired_groups, cittadino **citizens_data,
+                               int num_workers, StatistichePotatura *stats) {
+    char *print_at = (char *)calloc(desired_groups + 1, sizeof(char));
+    if (!print_at) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il clustering.\n");
+        exit(EXIT_FAILURE);
+    }
+    print_at[desired_groups] = 1;
+    perform_greedy_sweep(borda_scores_matrix, distance_store, ballot_classes, num_citizens, num_projects, desired_groups, print_at, citizens_data,
+                         num_workers, NULL, stats);
+    free(print_at);
+}
+
+/*
+ * @brief Clustering greedy incrementale in k: aggiunge un rappresentante alla volta fino a max_groups, registra il costo
+ * totale (la somma delle distanze dei cittadini dal loro rappresentante, come in print_cluster_output) dopo ogni
+ * rappresentante e stampa il raggruppamento completo solo per i k richiesti. Il raggruppamento con k gruppi e' lo
+ * stesso che perform_greedy_clustering produrrebbe con desired_groups = k.
+ * Il calcolo avviene sulle classi di schede identiche, pesate per numero di cittadini: cittadini della
+ * stessa classe hanno la stessa riga Borda, quindi le stesse distanze e lo stesso rappresentante.
+ * @param borda_scores_matrix Matrice dei punteggi Borda per classe (usata per calcolare le distanze).
+ * @param distance_store Distanze tra le classi (triangolo superiore), riempite qui; senza dati si ricalcolano al volo.
+ * @param ballot_classes Classi di schede identiche.
  * @param num_citizens Numero di abitanti.
  * @param num_projects Numero di progetti.
- * @param desired_groups Numero di gruppi desiderati.
+ * @param max_groups Numero massimo di gruppi (almeno 1).
+ * @param print_at Array di max_groups + 1 elementi: se print_at[k] e' diverso da 0 si stampano i gruppi con k rappresentanti.
+ *        Se i cittadini distinti finiscono prima di max_groups, i k richiesti oltre l'ultimo danno un'unica stampa finale.
  * @param citizens_data Array di strutture cittadino.
+ * @param num_workers Numero massimo di thread per il calcolo delle distanze (1 = seriale).
+ * @param group_costs Se non NULL, array di max_groups + 1 elementi: group_costs[k] riceve il costo con k gruppi.
+ * @param stats Se non NULL, vi si sommano le distanze valutate ed evitate nell'aggiornamento delle assegnazioni.
+ * @return Il numero di gruppi raggiunti (minore di max_groups se i cittadini distinti sono meno).
  */
-void perform_greedy_clustering(vint *borda_scores_matrix, vint *distance_matrix, int num_citizens, int num_projects, int desired_groups, cittadino **citizens_data) {
-    /* Calcolo della matrice delle distanze tra i cittadini */
-    int i,j,k, new_representative_idx;
-    int min_total_distance = 1000000;
+int perform_greedy_sweep(const Matrice *borda_scores_matrix, DistanzeTriangolari *distance_store, const ClassiSchede *ballot_classes, int num_citizens, int num_projects, int max_groups,
+                         const char *print_at, cittadino **citizens_data, int num_workers, long *group_costs, StatistichePotatura *stats) {
+    int i, k, new_representative_idx;
+    int num_classes = ballot_classes->num_classi;
+    const int *weight = ballot_classes->peso;
+    int *distance_row = NULL;
+    long min_total_distance = 0;
     int initial_representative_idx = -1;
-    int remaining_groups_to_find = desired_groups - 1;
-    contatore **distance_sum_counters = NULL;
-    componente **cluster_components = NULL;
-        
-    for (i = 0; i < num_citizens - 1; ++i) {
-        for (j = i + 1; j < num_citizens; ++j) {
-            int current_distance = 0;
-            for (k = 0; k < num_projects; ++k) {
-                /* Distanza  == MANHATTAN == (o L1 norm) tra i vettori di punteggi Borda */
-                current_distance += abs(borda_scores_matrix[i][k] - borda_scores_matrix[j][k]);
+    int remaining_groups_to_find = max_groups - 1;
+    int found_groups = 1;
+    int round = 0;
+    long *distance_sums = NULL;             /* Somma pesata delle distanze di ogni classe da tutti i cittadini */
+    componente **class_components = NULL;
+    CodaCELF celf_queue;
+    int *representative_classes = NULL;     /* Classe di ciascun rappresentante, in ordine di scelta */
+    int *representative_slot = NULL;        /* Per ogni classe, la posizione del suo rappresentante attuale */
+    int *representative_gap = NULL;         /* Distanze del nuovo rappresentante dai precedenti */
+    StatistichePotatura pruning = {0, 0};
+
+    /* Calcolo delle distanze tra le classi; distance_row ospita poi una riga intera alla volta */
+    distance_row = (int *)malloc((num_classes > 0 ? num_classes : 1) * sizeof(int));
+    if (!distance_row) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per una riga delle distanze.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (distance_store->dati) {
+        fill_distance_store(borda_scores_matrix, distance_store, num_classes, num_projects, num_workers);
+    }
+
+    /* Somme in long: con le classi pesate, V * P^2 supera INT_MAX */
+    distance_sums = (long *)calloc(num_classes > 0 ? num_classes : 1, sizeof(long));
+    if (!distance_sums) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per le somme delle distanze.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Calcola la somma delle distanze di ogni classe da tutti i cittadini */
+    for (i = 0; i < num_classes; ++i) {
+        load_distance_row(borda_scores_matrix, distance_store, i, num_projects, distance_row);
+        for (k = 0; k < num_classes; ++k) {
+            distance_sums[i] += (long)weight[k] * distance_row[k];
+        }
+    }
+    
+    /* Trova la classe con la somma delle distanze minima (primo rappresentante del cluster); il minimo parte dalla prima classe */
+    for (i = 0; i < num_classes; ++i) {
+        long current_score = distance_sums[i];
+        if (initial_representative_idx == -1 || current_score < min_total_distance ||
+            (current_score == min_total_distance &&
+             precedes_on_tie(ballot_classes->rappresentante[i], ballot_classes->rappresentante[initial_representative_idx], citizens_data))) {
+            /* In caso di parit, ordina lessicograficamente per codice cittadino */
+            min_total_distance = current_score;
+            initial_representative_idx = i;
+        }
+    }
+    
+    /* Inizializza le componenti per classe: rappr  il cittadino rappresentante, min la distanza da esso */
+    class_components = initialize_component_array(num_classes);
+
+    /* Assegna tutte le classi al primo rappresentante */
+    representative_classes = (int *)malloc(max_groups * sizeof(int));
+    representative_gap = (int *)malloc(max_groups * sizeof(int));
+    representative_slot = (int *)calloc(num_classes > 0 ? num_classes : 1, sizeof(int));
+    if (!representative_classes || !representative_gap || !representative_slot) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per i rappresentanti del clustering.\n");
+        exit(EXIT_FAILURE);
+    }
+    representative_classes[0] = initial_representative_idx;
+    load_distance_row(borda_scores_matrix, distance_store, initial_representative_idx, num_projects, distance_row);
+    for (k = 0; k < num_classes; ++k) {
+        class_components[k]->rappr = ballot_classes->rappresentante[initial_representative_idx];
+        class_components[k]->min = distance_row[k]; /* Distanza dal rappresentante */
+    }
+    record_greedy_round(ballot_classes, class_components, num_citizens, found_groups, print_at, citizens_data, group_costs);
+
+    /* Greedy pigro (CELF): invece di ricalcolare a ogni turno il costo di ogni classe non assegnata, si tiene
+     * una coda dei guadagni (costo attuale - costo con la classe come rappresentante) e si ricalcola solo la
+     * cima finche' non e' aggiornata al turno corrente. Minimo costo e massimo guadagno coincidono nello stesso
+     * turno, e a parita' la coda usa la stessa regola: i rappresentanti scelti non cambiano. */
+    celf_queue.voci = NULL;
+    celf_queue.dimensione = 0;
+    if (remaining_groups_to_find > 0) {
+        celf_queue.voci = (CandidatoCELF *)malloc((num_classes > 0 ? num_classes : 1) * sizeof(CandidatoCELF));
+        if (!celf_queue.voci) {
+            fprintf(stderr, "ERRORE: Allocazione fallita per la coda dei candidati.\n");
+            exit(EXIT_FAILURE);
+        }
+        celf_queue.rappresentante = ballot_classes->rappresentante;
+        celf_queue.citizens_data = citizens_data;
+        for (i = 0; i < num_classes; ++i) {
+            /* Se min  0, la classe contiene un rappresentante o  a distanza 0 da un rappresentante */
+            if (class_components[i]->min != 0) {
+                load_distance_row(borda_scores_matrix, distance_store, i, num_projects, distance_row);
+                celf_queue.voci[celf_queue.dimensione].guadagno = celf_gain(distance_row, class_components, weight, num_classes);
+                celf_queue.voci[celf_queue.dimensione].classe = i;
+                celf_queue.voci[celf_queue.dimensione].turno = 0;
+                celf_queue.dimensione++;
             }
-            distance_matrix[i][j] = current_distance;
-            distance_matrix[j][i] = current_distance; /* La matrice delle distanze  simmetrica */
+        }
+        for (i = celf_queue.dimensione / 2 - 1; i >= 0; --i) {
+            celf_sift_down(&celf_queue, i);
         }
     }
 
+    while (remaining_groups_to_find > 0) {
+        /* Trova il nuovo rappresentante tra le classi non ancora assegnate */
+        new_representative_idx = -1;
+        while (celf_queue.dimensione > 0) {
+            CandidatoCELF top = celf_queue.voci[0];
+            if (class_components[top.classe]->min != 0 && top.turno != round) {
+                /* Limite superiore di un turno precedente: ricalcola il guadagno e riposiziona la cima */
+                load_distance_row(borda_scores_matrix, distance_store, top.classe, num_projects, distance_row);
+                celf_queue.voci[0].guadagno = celf_gain(distance_row, class_components, weight, num_classes);
+                celf_queue.voci[0].turno = round;
+                celf_sift_down(&celf_queue, 0);
+                continue;
+            }
+            celf_queue.voci[0] = celf_queue.voci[--celf_queue.dimensione];
+            celf_sift_down(&celf_queue, 0);
+            if (class_components[top.classe]->min != 0) {
+                new_representative_idx = top.classe; /* Guadagno aggiornato: nessun altro candidato puo' superarlo */
+                break;
+            }
+            /* Ora a distanza 0 da un rappresentante: non e' piu' candidata */
+        }
+        if (new_representative_idx == -1) {
+            break; /* Ogni cittadino coincide gia' con un rappresentante: non ci sono altri gruppi distinti */
+        }
 
-    distance_sum_counters = initialize_counter_array(num_citizens); /* Inizializza contatori per le somme delle distanze */
+        /* Aggiorna le assegnazioni dei cluster con il nuovo rappresentante. Per la disuguaglianza triangolare
+         * d(k, nuovo) >= d(nuovo, attuale) - d(k, attuale): se d(nuovo, attuale) > 2 * min la classe k resta
+         * strettamente piu' vicina al suo rappresentante e la distanza non va calcolata */
+        for (i = 0; i < found_groups; ++i) {
+            representative_gap[i] = pair_distance(borda_scores_matrix, distance_store, new_representative_idx, representative_classes[i], num_projects);
+        }
+        for (k = 0; k < num_classes; ++k) {
+            int new_representative = ballot_classes->rappresentante[new_representative_idx];
+            int distance;
+            if (representative_gap[representative_slot[k]] > 2 * class_components[k]->min) {
+                pruning.evitate++;
+                continue;
+            }
+            distance = pair_distance(borda_scores_matrix, distance_store, k, new_representative_idx, num_projects);
+            pruning.valutate++;
+            if (distance < class_components[k]->min) {
+                class_components[k]->rappr = new_representative;
+                class_components[k]->min = distance;
+                representative_slot[k] = found_groups;
+            } else if (distance == class_components[k]->min) {
+                /* In caso di parit di distanza, preferisci il rappresentante con codice lessicograficamente minore */
+                if (citizens_data[new_representative]->rango_cf < citizens_data[class_components[k]->rappr]->rango_cf) {
+                    class_components[k]->rappr = new_representative;
+                    representative_slot[k] = found_groups;
+                }
+            }
+        }
+        representative_classes[found_groups] = new_representative_idx;
+        remaining_groups_to_find--;
+        found_groups++;
+        round++;
+        record_greedy_round(ballot_classes, class_components, num_citizens, found_groups, print_at, citizens_data, group_costs);
+    }
 
-    /* Calcola la somma delle distanze di ogni cittadino da tutti gli altri */
-    for (i = 0; i < num_citizens; ++i) {
-        for (k = 0; k < num_citizens; ++k) {
-            distance_sum_counters[i]->cont += distance_matrix[i][k];
+    /* Interrotto prima di max_groups: i k richiesti oltre l'ultimo hanno gli stessi gruppi dell'ultimo turno */
+    for (k = found_groups + 1; k <= max_groups; ++k) {
+        if (print_at[k]) {
+            print_class_assignment(ballot_classes, class_components, num_citizens, found_groups, citizens_data);
+            break;
         }
-        distance_sum_counters[i]->indice = i; /* L'indice rappresenta l'ID del cittadino */
     }
     
-    /* Trova il cittadino con la somma delle distanze minima (primo rappresentante del cluster) */
+    /* Libera la memoria allocata internamente a questa funzione */
+    for (i = 0; i < num_classes; ++i) {
+        free(class_components[i]);
+    }
+    free(distance_sums);
+    free(class_components);
+    free(distance_row);
+    free(celf_queue.voci);
+    free(representative_classes);
+    free(representative_slot);
+    free(representative_gap);
+    if (stats) {
+        stats->valutate += pruning.valutate;
+        stats->evitate += pruning.evitate;
+    }
+    return found_groups;
+}
 
+/*
+ * @brief Clustering k-medoidi a campionamento (CLARA con ricerca locale CLARANS), per elettorati troppo grandi
+ * per il greedy quadratico. Per CLARA_CAMPIONI volte:
+ * - estrae sample_size cittadini a caso e li raccoglie nelle loro classi di schede, pesate per le estrazioni;
+ * - sceglie i medoidi del campione con lo stesso greedy di perform_greedy_clustering;
+ * - li migliora con scambi casuali medoide/non medoide finche' CLARANS_VICINI scambi di fila non
+ *   abbassano il costo del campione;
+ * - valuta i medoidi su tutte le classi, in O(V*K*P).
+ * Ogni classe va poi al medoide piu' vicino del campione migliore (a parita' di distanza, quello che precede
+ * secondo la regola del clustering) e l'esito viene stampato nel formato di print_cluster_output.
+ * @param borda_scores_matrix Matrice dei punteggi Borda per classe.
+ * @param ballot_classes Classi di schede identiche.
+ * @param num_citizens Numero di abitanti.
+ * @param num_projects Numero di progetti.
+ * @param desired_groups Numero di gruppi desiderati (almeno 1, verificato alla lettura dei parametri).
+ * @param citizens_data Array di strutture cittadino.
+ * @param sample_size Cittadini estratti per campione.
+ * @param seed Seme del generatore pseudo-casuale: a parita' di seme e di input l'esito e' lo stesso.
+ * @param stats Se non NULL, vi si sommano le distanze valutate ed evitate nelle assegnazioni ai medoidi.
+ */
+void perform_sampled_clustering(const Matrice *borda_scores_matrix, const ClassiSchede *ballot_classes, int num_citizens, int num_projects, int desired_groups,
+                                cittadino **citizens_data, int sample_size, unsigned long seed, StatistichePotatura *stats) {
+    int num_classes = ballot_classes->num_classi;
+    unsigned long random_state = (seed * 2654435761UL + 1UL) & 0xFFFFFFFFUL;
+    int *sample_classes, *sample_weight, *sample_position, *sample_distances;
+    int *medoids, *trial_medoids, *best_medoids;
+    int num_medoids, best_num_medoids = 0, found_groups;
+    long best_cost = -1;
+    int draw, t, u, k;
+    componente **class_components = NULL;
+    componente **cluster_components = NULL;
 
-    for (i = 0; i < num_citizens; ++i) {
-        int current_score = distance_sum_counters[i]->cont;
-        if (initial_representative_idx == -1 || current_score < min_total_distance) {
-            min_total_distance = current_score;
-            initial_representative_idx = distance_sum_counters[i]->indice;
-        } else if (current_score == min_total_distance) {
-            /* In caso di parit, ordina lessicograficamente per codice cittadino */
-            if (strcmp(citizens_data[distance_sum_counters[i]->indice]->CF, citizens_data[initial_representative_idx]->CF) < 0) {
-                initial_representative_idx = distance_sum_counters[i]->indice;
+    if (random_state == 0) {
+        random_state = 1; /* Lo stato nullo e' un punto fisso di xorshift */
+    }
+    sample_classes = (int *)malloc(sample_size * sizeof(int));
+    sample_weight = (int *)malloc(sample_size * sizeof(int));
+    sample_position = (int *)malloc((num_classes > 0 ? num_classes : 1) * sizeof(int));
+    sample_distances = (int *)malloc((size_t)sample_size * sample_size * sizeof(int));
+    medoids = (int *)malloc(desired_groups * sizeof(int));
+    trial_medoids = (int *)malloc(desired_groups * sizeof(int));
+    best_medoids = (int *)malloc(desired_groups * sizeof(int));
+    if (!sample_classes || !sample_weight || !sample_position || !sample_distances || !medoids || !trial_medoids || !best_medoids) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il clustering a campionamento.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (t = 0; t < num_classes; ++t) {
+        sample_position[t] = -1;
+    }
+    class_components = initialize_component_array(num_classes);
+
+    for (draw = 0; draw < CLARA_CAMPIONI; ++draw) {
+        int sample_count = 0, failures = 0, max_failures;
+        long cost;
+
+        /* Estrazione dei cittadini, raccolti per classe */
+        for (t = 0; t < sample_size; ++t) {
+            int class_idx = ballot_classes->classe_di[next_random(&random_state) % (unsigned long)num_citizens];
+            if (sample_position[class_idx] < 0) {
+                sample_position[class_idx] = sample_count;
+                sample_classes[sample_count] = class_idx;
+                sample_weight[sample_count] = 0;
+                sample_count++;
+            }
+            sample_weight[sample_position[class_idx]]++;
+        }
+        for (t = 0; t < sample_count; ++t) {
+            sample_position[sample_classes[t]] = -1;
+        }
+
+        /* Distanze tra le classi del campione */
+        for (t = 0; t < sample_count; ++t) {
+            sample_distances[(size_t)t * sample_count + t] = 0;
+            for (u = t + 1; u < sample_count; ++u) {
+                int distance = class_distance(borda_scores_matrix, sample_classes[t], sample_classes[u], num_projects);
+                sample_distances[(size_t)t * sample_count + u] = distance;
+                sample_distances[(size_t)u * sample_count + t] = distance;
+            }
+        }
+
+        num_medoids = build_sample_medoids(sample_distances, sample_weight, sample_classes, sample_count, desired_groups,
+                                           ballot_classes, citizens_data, medoids);
+
+        /* Ricerca locale: scambi casuali medoide / non medoide, accettati solo se abbassano il costo */
+        cost = sample_cost(sample_distances, sample_weight, sample_count, medoids, num_medoids);
+        max_failures = num_medoids * (sample_count - num_medoids) < CLARANS_VICINI ? num_medoids * (sample_count - num_medoids) : CLARANS_VICINI;
+        while (failures < max_failures) {
+            int slot = (int)(next_random(&random_state) % (unsigned long)num_medoids);
+            int candidate = (int)(next_random(&random_state) % (unsigned long)sample_count);
+            int previous = medoids[slot];
+            long new_cost;
+            int already_medoid = 0;
+            for (k = 0; k < num_medoids; ++k) {
+                already_medoid |= (medoids[k] == candidate);
+            }
+            if (already_medoid) {
+                failures++;
+                continue;
+            }
+            medoids[slot] = candidate;
+            new_cost = sample_cost(sample_distances, sample_weight, sample_count, medoids, num_medoids);
+            if (new_cost < cost) {
+                cost = new_cost;
+                failures = 0;
+            } else {
+                medoids[slot] = previous;
+                failures++;
             }
         }
+
+        /* Valutazione su tutto l'elettorato */
+        for (k = 0; k < num_medoids; ++k) {
+            trial_medoids[k] = sample_classes[medoids[k]];
+        }
+        cost = assign_to_medoids(borda_scores_matrix, ballot_classes, trial_medoids, num_medoids, num_projects, citizens_data, class_components, stats);
+        if (best_cost < 0 || cost < best_cost) {
+            best_cost = cost;
+            best_num_medoids = num_medoids;
+            memcpy(best_medoids, trial_medoids, num_medoids * sizeof(int));
+        }
     }
-    
-    /* Inizializza le componenti dei cluster */
-    cluster_components = initialize_component_array(num_citizens);
 
-    /* Assegna tutti i cittadini al primo rappresentante */
+    /* Assegnazione finale di ogni classe, poi di ogni cittadino */
+    assign_to_medoids(borda_scores_matrix, ballot_classes, best_medoids, best_num_medoids, num_projects, citizens_data, class_components, stats);
+    cluster_components = initialize_component_array(num_citizens);
     for (k = 0; k < num_citizens; ++k) {
-        cluster_components[k]->rappr = initial_representative_idx;
-        cluster_components[k]->min = distance_matrix[initial_representative_idx][k]; /* Distanza dal rappresentante */
+        const componente *assigned = class_components[ballot_classes->classe_di[k]];
+        cluster_components[k]->rappr = assigned->rappr;
+        cluster_components[k]->min = assigned->min;
     }
+    qsort_clustering(cluster_components, 0, num_citizens - 1, citizens_data);
 
-    while (remaining_groups_to_find > 0) {
-        int active_citizens_count = 0;
-        /* Ricostruisce distance_sum_counters solo per i cittadini non ancora assegnati al loro cluster finale */
-        for (i = 0; i < num_citizens; ++i) {
-            /* Se min  0, significa che 'i'  gi un rappresentante o  a distanza 0 da un rappresentante */
-            if (cluster_components[i]->min != 0) {
-                /* Calcola la somma delle distanze per ogni cittadino rispetto ai rappresentanti attuali */
-                distance_sum_counters[active_citizens_count]->cont = 0;
-                distance_sum_counters[active_citizens_count]->indice = i;
-                for (k = 0; k < num_citizens; ++k) {
-                    if (distance_matrix[i][k] < cluster_components[k]->min) {
-                        distance_sum_counters[active_citizens_count]->cont += distance_matrix[i][k];
-                    } else {
-                        distance_sum_counters[active_citizens_count]->cont += cluster_components[k]->min;
-                    }
-                }
-                active_citizens_count++;
-            }
+    /* Medoidi con le stesse distanze si contendono le stesse classi: conta solo i gruppi non vuoti */
+    found_groups = num_citizens > 0 ? 1 : 0;
+    for (k = 1; k < num_citizens; ++k) {
+        if (cluster_components[k]->rappr != cluster_components[k - 1]->rappr) {
+            found_groups++;
         }
+    }
+    print_cluster_output(cluster_components, citizens_data, num_citizens, found_groups);
 
-        /* Trova il nuovo rappresentante tra i cittadini non ancora assegnati, si poteva inserire nel while ma si  preferita la leggibilit del codice */
-        min_total_distance = -1;
-        new_representative_idx = -1;
-        
-        for (i = 0; i < active_citizens_count; ++i) {
-            int current_score = distance_sum_counters[i]->cont;
-            if (new_representative_idx == -1 || current_score < min_total_distance) {
-                min_total_distance = current_score;
-                new_representative_idx = distance_sum_counters[i]->indice;
-            } else if (current_score == min_total_distance) {
-                if (strcmp(citizens_data[distance_sum_counters[i]->indice]->CF, citizens_data[new_representative_idx]->CF) < 0) {
-                    new_representative_idx = distance_sum_counters[i]->indice;
+    for (t = 0; t < num_classes; ++t) {
+        free(class_components[t]);
+    }
+    for (t = 0; t < num_citizens; ++t) {
+        free(cluster_components[t]);
+    }
+    free(class_components);
+    free(cluster_components);
+    free(sample_classes);
+    free(sample_weight);
+    free(sample_position);
+    free(sample_distances);
+    free(medoids);
+    free(trial_medoids);
+    free(best_medoids);
+}
+
+/*
+ * @brief Calcola le distanze L1 dalla riga Borda i alle righe da first a num_rows - 1, alla larghezza della matrice.
+ * @param borda_matrix Matrice Borda.
+ * @param i La riga di partenza.
+ * @param first La prima riga di arrivo.
+ * @param num_rows Numero di righe.
+ * @param num_projects Numero di progetti.
+ * @param distances Distanze da i a j in posizione j - first.
+ */
+static void compute_distance_row(const Matrice *borda_matrix, int i, int first, int num_rows, int num_projects, int *distances) {
+    const KernelDistanzaL1 *l1 = select_l1_kernel((size_t)num_projects * borda_matrix->larghezza);
+    /* Il riempimento delle righe e' zero in entrambe: allungarle fino a un multiplo del blocco del kernel
+     * non cambia la distanza ed evita il ciclo scalare sul resto */
+    size_t length = ((size_t)num_projects * borda_matrix->larghezza + l1->blocco - 1) / l1->blocco * l1->blocco;
+    if (length > borda_matrix->passo) {
+        length = borda_matrix->passo;
+    }
+    num_projects = (int)(length / borda_matrix->larghezza);
+    switch (borda_matrix->larghezza) {
+        case 1: distance_row_u8(borda_matrix, i, first, num_rows, num_projects, distances, l1); break;
+        case 2: distance_row_u16(borda_matrix, i, first, num_rows, num_projects, distances, l1); break;
+        default: distance_row_i32(borda_matrix, i, first, num_rows, num_projects, distances, l1); break;
+    }
+}
+
+/*
+ * @brief Calcola le distanze L1 tra tutte le righe Borda e le memorizza nel triangolo superiore.
+ * Distanza  == MANHATTAN == (o L1 norm) tra i vettori di punteggi Borda.
+ * Il lavoro e' diviso in tessere (vedi LavoroDistanze) prelevate dai thread man mano che si liberano; ogni
+ * tessera scrive segmenti di riga propri del triangolo, quindi non serve sincronizzare le scritture.
+ * @param borda_matrix Matrice Borda (una riga per classe di schede).
+ * @param distance_store Le distanze da riempire.
+ * @param num_rows Numero di righe.
+ * @param num_projects Numero di progetti.
+ * @param num_workers Numero massimo di thread.
+ */
+static void fill_distance_store(const Matrice *borda_matrix, DistanzeTriangolari *distance_store, int num_rows, int num_projects, int num_workers) {
+    LavoroDistanze job;
+    int block_rows, num_blocks, num_tiles, tile, w, I, J;
+
+    if (num_rows < 2) {
+        return;
+    }
+    if (num_workers < 1) {
+        num_workers = 1;
+    }
+    /* Blocchi grandi quanto la cache consente, ma almeno 4 per thread per bilanciare il carico */
+    block_rows = (int)(DISTANZE_BLOCCO_BYTE / (borda_matrix->passo > 0 ? borda_matrix->passo : 1));
+    if (num_workers > 1 && block_rows > (num_rows + 4 * num_workers - 1) / (4 * num_workers)) {
+        block_rows = (num_rows + 4 * num_workers - 1) / (4 * num_workers);
+    }
+    if (block_rows < DISTANZE_BLOCCO_MIN_RIGHE) {
+        block_rows = DISTANZE_BLOCCO_MIN_RIGHE;
+    }
+    num_blocks = (num_rows + block_rows - 1) / block_rows;
+    num_tiles = num_blocks * (num_blocks + 1) / 2;
+    if (num_workers > num_tiles) {
+        num_workers = num_tiles;
+    }
+
+    job.borda = borda_matrix;
+    job.distances = distance_store;
+    job.num_rows = num_rows;
+    job.num_projects = num_projects;
+    job.blocco_righe = block_rows;
+    job.tessera_riga = (int *)malloc(num_tiles * sizeof(int));
+    job.tessera_colonna = (int *)malloc(num_tiles * sizeof(int));
+    job.buffers = (int **)calloc(num_workers, sizeof(int *));
+    if (!job.tessera_riga || !job.tessera_colonna || !job.buffers) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il calcolo delle distanze.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (w = 0; w < num_workers; ++w) {
+        job.buffers[w] = (int *)malloc(block_rows * sizeof(int));
+        if (!job.buffers[w]) {
+            fprintf(stderr, "ERRORE: Allocazione fallita per il calcolo delle distanze.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (I = 0, tile = 0; I < num_blocks; ++I) {
+        for (J = I; J < num_blocks; ++J, ++tile) {
+            job.tessera_riga[tile] = I;
+            job.tessera_colonna[tile] = J;
+        }
+    }
+
+    select_l1_kernel((size_t)num_projects * borda_matrix->larghezza); /* Rileva la CPU prima di avviare i thread */
+    run_parallel_tasks(num_workers, num_tiles, distance_tile, &job);
+
+    for (w = 0; w < num_workers; ++w) {
+        free(job.buffers[w]);
+    }
+    free(job.buffers);
+    free(job.tessera_riga);
+    free(job.tessera_colonna);
+}
+
+/*
+ * @brief Calcola una tessera del triangolo delle distanze: righe del blocco I contro colonne del blocco J.
+ * @param context Puntatore a LavoroDistanze.
+ * @param task Indice della tessera.
+ * @param worker Indice del thread (sceglie il buffer).
+ */
+static void distance_tile(void *context, int task, int worker) {
+    LavoroDistanze *job = (LavoroDistanze *)context;
+    int first_row = job->tessera_riga[task] * job->blocco_righe;
+    int last_row = first_row + job->blocco_righe < job->num_rows ? first_row + job->blocco_righe : job->num_rows;
+    int first_col = job->tessera_colonna[task] * job->blocco_righe;
+    int last_col = first_col + job->blocco_righe < job->num_rows ? first_col + job->blocco_righe : job->num_rows;
+    int *buffer = job->buffers[worker];
+    int i;
+    for (i = first_row; i < last_row; ++i) {
+        int first = i + 1 > first_col ? i + 1 : first_col; /* Sulla diagonale solo j > i */
+        if (first >= last_col) {
+            continue;
+        }
+        compute_distance_row(job->borda, i, first, last_col, job->num_projects, buffer);
+        store_distance_segment(job->distances, i, first, last_col - first, buffer);
+    }
+}
+
+/*
+ * @brief Restituisce l'intera riga i delle distanze: dal triangolo se e' stato allocato,
+ * altrimenti (modalita' senza matrice) ricalcolandola dalla matrice Borda.
+ * @param borda_matrix Matrice Borda.
+ * @param distance_store Le distanze, eventualmente senza dati.
+ * @param i La riga.
+ * @param num_projects Numero di progetti.
+ * @param row Vettore di num_righe int da riempire.
+ */
+static void load_distance_row(const Matrice *borda_matrix, const DistanzeTriangolari *distance_store, int i, int num_projects, int *row) {
+    if (distance_store->dati) {
+        copy_distance_row(distance_store, i, row);
+    } else {
+        compute_distance_row(borda_matrix, i, 0, distance_store->num_righe, num_projects, row);
+    }
+}
+
+/*
+ * @brief Guadagno di una classe come nuovo rappresentante: di quanto scende la somma pesata delle distanze
+ * di ogni classe dal suo rappresentante piu' vicino.
+ * @param distance_row Distanze della classe candidata da tutte le classi.
+ * @param class_components Componenti per classe (min = distanza dal rappresentante attuale).
+ * @param weight Peso di ciascuna classe.
+ * @param num_classes Numero di classi.
+ * @return Il guadagno (>= 0).
+ */
+static long celf_gain(const int *distance_row, componente **class_components, const int *weight, int num_classes) {
+    long gain = 0;
+    int k;
+    for (k = 0; k < num_classes; ++k) {
+        if (distance_row[k] < class_components[k]->min) {
+            gain += (long)weight[k] * (class_components[k]->min - distance_row[k]);
+        }
+    }
+    return gain;
+}
+
+/*
+ * @brief Riporta al suo posto nella coda CELF l'elemento in posizione 'position', scendendo verso le foglie.
+ * Ordine: guadagno maggiore prima; a parita', il rappresentante che precede secondo precedes_on_tie.
+ * @param queue La coda.
+ * @param position La posizione da sistemare.
+ */
+static void celf_sift_down(CodaCELF *queue, int position) {
+    CandidatoCELF moving = queue->voci[position];
+    for (;;) {
+        int child = 2 * position + 1, best;
+        if (child >= queue->dimensione) {
+            break;
+        }
+        best = child;
+        if (child + 1 < queue->dimensione &&
+            (queue->voci[child + 1].guadagno > queue->voci[child].guadagno ||
+             (queue->voci[child + 1].guadagno == queue->voci[child].guadagno &&
+              precedes_on_tie(queue->rappresentante[queue->voci[child + 1].classe], queue->rappresentante[queue->voci[child].classe], queue->citizens_data)))) {
+            best = child + 1;
+        }
+        if (moving.guadagno > queue->voci[best].guadagno ||
+            (moving.guadagno == queue->voci[best].guadagno &&
+             precedes_on_tie(queue->rappresentante[moving.classe], queue->rappresentante[queue->voci[best].classe], queue->citizens_data))) {
+            break;
+        }
+        queue->voci[position] = queue->voci[best];
+        position = best;
+    }
+    queue->voci[position] = moving;
+}
+
+/*
+ * @brief Generatore pseudo-casuale xorshift a 32 bit, identico su ogni piattaforma (a differenza di rand()).
+ * @param state Lo stato, non nullo, aggiornato a ogni chiamata.
+ * @return Il prossimo numero, tra 1 e 2^32 - 1.
+ */
+static unsigned long next_random(unsigned long *state) {
+    unsigned long x = *state;
+    x ^= (x << 13) & 0xFFFFFFFFUL;
+    x ^= x >> 17;
+    x ^= (x << 5) & 0xFFFFFFFFUL;
+    *state = x;
+    return x;
+}
+
+/*
+ * @brief Distanza L1 tra le righe Borda di due classi.
+ * @param borda_matrix Matrice Borda.
+ * @param first La prima classe.
+ * @param second La seconda classe.
+ * @param num_projects Numero di progetti.
+ * @return La distanza.
+ */
+static int class_distance(const Matrice *borda_matrix, int first, int second, int num_projects) {
+    int distance;
+    compute_distance_row(borda_matrix, first, second, second + 1, num_projects, &distance);
+    return distance;
+}
+
+/*
+ * @brief Sceglie fino a desired_groups medoidi tra le classi del campione con il greedy di perform_greedy_clustering:
+ * prima la classe con somma pesata delle distanze minima, poi via via quella che la riduce di piu'.
+ * @param sample_distances Distanze tra le classi del campione (sample_count x sample_count).
+ * @param sample_weight Estrazioni di ciascuna classe del campione.
+ * @param sample_classes Classe di ciascun elemento del campione.
+ * @param sample_count Numero di classi nel campione.
+ * @param desired_groups Numero di medoidi desiderati.
+ * @param ballot_classes Classi di schede (per i rappresentanti della regola di parita').
+ * @param citizens_data Array di strutture cittadino.
+ * @param medoids Posizioni nel campione dei medoidi scelti.
+ * @return Il numero di medoidi scelti (meno di desired_groups se il campione non ha abbastanza classi distinte).
+ */
+static int build_sample_medoids(const int *sample_distances, const int *sample_weight, const int *sample_classes, int sample_count,
+                                int desired_groups, const ClassiSchede *ballot_classes, cittadino **citizens_data, int *medoids) {
+    const int *representative = ballot_classes->rappresentante;
+    int *nearest = (int *)malloc((sample_count > 0 ? sample_count : 1) * sizeof(int));
+    int num_medoids = 0, t, u, best;
+    long best_score = 0;
+
+    if (!nearest) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il clustering a campionamento.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (best = -1, t = 0; t < sample_count; ++t) {
+        long total = 0;
+        for (u = 0; u < sample_count; ++u) {
+            total += (long)sample_weight[u] * sample_distances[(size_t)t * sample_count + u];
+        }
+        if (best == -1 || total < best_score ||
+            (total == best_score && precedes_on_tie(representative[sample_classes[t]], representative[sample_classes[best]], citizens_data))) {
+            best_score = total;
+            best = t;
+        }
+    }
+    while (best != -1) {
+        medoids[num_medoids++] = best;
+        for (u = 0; u < sample_count; ++u) {
+            int distance = sample_distances[(size_t)best * sample_count + u];
+            if (num_medoids == 1 || distance < nearest[u]) {
+                nearest[u] = distance;
+            }
+        }
+        if (num_medoids >= desired_groups) {
+            break;
+        }
+        for (best = -1, t = 0; t < sample_count; ++t) {
+            long gain = 0;
+            if (nearest[t] == 0) {
+                continue; /* Medoide, o a distanza 0 da un medoide */
+            }
+            for (u = 0; u < sample_count; ++u) {
+                int distance = sample_distances[(size_t)t * sample_count + u];
+                if (distance < nearest[u]) {
+                    gain += (long)sample_weight[u] * (nearest[u] - distance);
                 }
             }
+            if (best == -1 || gain > best_score ||
+                (gain == best_score && precedes_on_tie(representative[sample_classes[t]], representative[sample_classes[best]], citizens_data))) {
+                best_score = gain;
+                best = t;
+            }
         }
+    }
+    free(nearest);
+    return num_medoids;
+}
 
-        /* Aggiorna le assegnazioni dei cluster con il nuovo rappresentante */
-        for (k = 0; k < num_citizens; ++k) {
-            if (distance_matrix[new_representative_idx][k] < cluster_components[k]->min) {
-                cluster_components[k]->rappr = new_representative_idx;
-                cluster_components[k]->min = distance_matrix[new_representative_idx][k];
-            } else if (distance_matrix[new_representative_idx][k] == cluster_components[k]->min) {
-                /* In caso di parit di distanza, preferisci il rappresentante con codice lessicograficamente minore */
-                if (strcmp(citizens_data[new_representative_idx]->CF, citizens_data[cluster_components[k]->rappr]->CF) < 0) {
-                    cluster_components[k]->rappr = new_representative_idx;
-                }
+/*
+ * @brief Costo di un insieme di medoidi sul campione: somma pesata delle distanze dal medoide piu' vicino.
+ * @param sample_distances Distanze tra le classi del campione.
+ * @param sample_weight Estrazioni di ciascuna classe del campione.
+ * @param sample_count Numero di classi nel campione.
+ * @param medoids Posizioni dei medoidi nel campione.
+ * @param num_medoids Numero di medoidi.
+ * @return Il costo.
+ */
+static long sample_cost(const int *sample_distances, const int *sample_weight, int sample_count, const int *medoids, int num_medoids) {
+    long cost = 0;
+    int u, k;
+    for (u = 0; u < sample_count; ++u) {
+        int nearest = sample_distances[(size_t)medoids[0] * sample_count + u];
+        for (k = 1; k < num_medoids; ++k) {
+            int distance = sample_distances[(size_t)medoids[k] * sample_count + u];
+            if (distance < nearest) {
+                nearest = distance;
             }
         }
-        remaining_groups_to_find--;
+        cost += (long)sample_weight[u] * nearest;
+    }
+    return cost;
+}
+
+/*
+ * @brief Riporta l'assegnazione delle classi su ciascun cittadino, ordina e stampa i gruppi.
+ * @param ballot_classes Classi di schede identiche.
+ * @param class_components Per ogni classe: rappresentante assegnato e distanza da esso.
+ * @param num_citizens Numero di abitanti.
+ * @param num_groups Numero di gruppi.
+ * @param citizens_data Array di strutture cittadino.
+ */
+static void print_class_assignment(const ClassiSchede *ballot_classes, componente **class_components, int num_citizens, int num_groups, cittadino **citizens_data) {
+    int k;
+    componente **cluster_components = initialize_component_array(num_citizens);
+    for (k = 0; k < num_citizens; ++k) {
+        const componente *assigned = class_components[ballot_classes->classe_di[k]];
+        cluster_components[k]->rappr = assigned->rappr;
+        cluster_components[k]->min = assigned->min;
     }
     
     /* Ordina i componenti del cluster per la stampa */
     qsort_clustering(cluster_components, 0, num_citizens - 1, citizens_data);
-    print_cluster_output(cluster_components, citizens_data, num_citizens, desired_groups); /* desired_groups  il numero finale di gruppi */
-    
-    /* Libera la memoria allocata internamente a questa funzione */
-    /* La memoria per `indici` non  pi necessaria dato che `distance_sum_counters`  usato per lo stesso scopo. */
-    for (i = 0; i < num_citizens; ++i) {
-        free(distance_sum_counters[i]);
-        free(cluster_components[i]);
+    print_cluster_output(cluster_components, citizens_data, num_citizens, num_groups);
+    for (k = 0; k < num_citizens; ++k) {
+        free(cluster_components[k]);
     }
-    free(distance_sum_counters);
     free(cluster_components);
 }
 
+/*
+ * @brief Chiude un turno del greedy incrementale: registra il costo con num_groups gruppi e, se richiesto, stampa i gruppi.
+ * @param ballot_classes Classi di schede identiche.
+ * @param class_components Per ogni classe: rappresentante assegnato e distanza da esso.
+ * @param num_citizens Numero di abitanti.
+ * @param num_groups Numero di rappresentanti scelti finora.
+ * @param print_at Per ogni k, se stampare i gruppi.
+ * @param citizens_data Array di strutture cittadino.
+ * @param group_costs Costi per numero di gruppi, o NULL.
+ */
+static void record_greedy_round(const ClassiSchede *ballot_classes, componente **class_components, int num_citizens, int num_groups,
+                                const char *print_at, cittadino **citizens_data, long *group_costs) {
+    int c;
+    if (group_costs) {
+        long cost = 0;
+        for (c = 0; c < ballot_classes->num_classi; ++c) {
+            cost += (long)ballot_classes->peso[c] * class_components[c]->min;
+        }
+        group_costs[num_groups] = cost;
+    }
+    if (print_at[num_groups]) {
+        print_class_assignment(ballot_classes, class_components, num_citizens, num_groups, citizens_data);
+    }
+}
+
+/*
+ * @brief Distanza tra due classi: dal triangolo se e' stato allocato, altrimenti calcolata dalla matrice Borda.
+ * @param borda_matrix Matrice Borda.
+ * @param distance_store Le distanze, eventualmente senza dati.
+ * @param first La prima classe.
+ * @param second La seconda classe.
+ * @param num_projects Numero di progetti.
+ * @return La distanza.
+ */
+static int pair_distance(const Matrice *borda_matrix, const DistanzeTriangolari *distance_store, int first, int second, int num_projects) {
+    if (distance_store->dati) {
+        return get_distance(distance_store, first, second);
+    }
+    return class_distance(borda_matrix, first, second, num_projects);
+}
+
+/*
+ * @brief Assegna ogni classe al medoide piu' vicino; a parita' di distanza vince il rappresentante che precede
+ * secondo la regola del clustering. Come nel greedy, se il medoide migliore finora dista da un altro medoide
+ * piu' del doppio della distanza della classe, quel medoide e' strettamente piu' lontano e non va valutato.
+ * @param borda_matrix Matrice Borda.
+ * @param ballot_classes Classi di schede.
+ * @param medoids Classi scelte come medoidi.
+ * @param num_medoids Numero di medoidi.
+ * @param num_projects Numero di progetti.
+ * @param citizens_data Array di strutture cittadino.
+ * @param class_components Per ogni classe: rappresentante assegnato e distanza da esso.
+ * @param stats Se non NULL, vi si sommano le distanze valutate ed evitate.
+ * @return La somma delle distanze di tutti i cittadini dal loro rappresentante.
+ */
+static long assign_to_medoids(const Matrice *borda_matrix, const ClassiSchede *ballot_classes, const int *medoids, int num_medoids,
+                              int num_projects, cittadino **citizens_data, componente **class_components, StatistichePotatura *stats) {
+    long cost = 0, evaluated = 0, pruned = 0;
+    int c, k, j;
+    int *medoid_gap = (int *)malloc((size_t)num_medoids * num_medoids * sizeof(int)); /* Distanze tra medoidi */
+    if (!medoid_gap) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per il clustering a campionamento.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (k = 0; k < num_medoids; ++k) {
+        medoid_gap[(size_t)k * num_medoids + k] = 0;
+        for (j = k + 1; j < num_medoids; ++j) {
+            medoid_gap[(size_t)k * num_medoids + j] = medoid_gap[(size_t)j * num_medoids + k] = class_distance(borda_matrix, medoids[k], medoids[j], num_projects);
+        }
+    }
+    for (c = 0; c < ballot_classes->num_classi; ++c) {
+        int best = 0;
+        class_components[c]->rappr = ballot_classes->rappresentante[medoids[0]];
+        class_components[c]->min = class_distance(borda_matrix, c, medoids[0], num_projects);
+        evaluated++;
+        for (k = 1; k < num_medoids; ++k) {
+            int candidate = ballot_classes->rappresentante[medoids[k]];
+            int distance;
+            if (medoid_gap[(size_t)best * num_medoids + k] > 2 * class_components[c]->min) {
+                pruned++;
+                continue;
+            }
+            distance = class_distance(borda_matrix, c, medoids[k], num_projects);
+            evaluated++;
+            if (distance < class_components[c]->min ||
+                (distance == class_components[c]->min && precedes_on_tie(candidate, class_components[c]->rappr, citizens_data))) {
+                class_components[c]->rappr = candidate;
+                class_components[c]->min = distance;
+                best = k;
+            }
+        }
+        cost += (long)ballot_classes->peso[c] * class_components[c]->min;
+    }
+    free(medoid_gap);
+    if (stats) {
+        stats->valutate += evaluated;
+        stats->evitate += pruned;
+    }
+    return cost;
+}
+
+/*
+ * @brief Regola di parit del clustering: codice fiscale minore, poi indice minore
+ * (lo stesso esito della scansione dei cittadini in ordine con confronto stretto).
+ * I codici si confrontano tramite il loro rango (rank_citizen_codes).
+ * @param first Indice del primo cittadino.
+ * @param second Indice del secondo cittadino.
+ * @param citizens_data Array di strutture cittadino.
+ * @return 1 se first precede second, 0 altrimenti.
+ */
+static int precedes_on_tie(int first, int second, cittadino **citizens_data) {
+    int first_rank = citizens_data[first]->rango_cf, second_rank = citizens_data[second]->rango_cf;
+    return first_rank < second_rank || (first_rank == second_rank && first < second);
+}
+
 
 /* ------------------------------Preparazione dati------------------------------ */
 
@@ -215,13 +1066,15 @@ void perform_greedy_clustering(vint *borda_scores_matrix, vint *distance_matrix,
  * @brief Aggrega i dati di preferenza di un cittadino per il metodo di pluralit.
  * @param citizen La struttura del cittadino le cui preferenze sono da aggiungere.
  * @param counters Array di contatori da aggiornare.
+ * @param weight Numero di cittadini con questa scheda.
+ * @param num_projects Numero di progetti.
  */
-void aggregate_plurality_data(cittadino citizen, contatore **counters) {
-    int i = 0;
-    do {
-        counters[citizen.progs[i]]->cont++; /* Incrementa il conteggio per il progetto preferito */
-        i++;
-    } while (i < PROG_LENGTH && citizen.pref[i - 1] == '='); /* Continua se ci sono preferenze pari */
+void aggregate_plurality_data(cittadino citizen, contatore **counters, int weight, int num_projects) {
+    switch (citizen.larghezza) {
+        case 1: plurality_u8(citizen.progs.u8, citizen.pref, counters, weight, num_projects); break;
+        case 2: plurality_u16(citizen.progs.u16, citizen.pref, counters, weight, num_projects); break;
+        default: plurality_i32(citizen.progs.i32, citizen.pref, counters, weight, num_projects); break;
+    }
 }
 
 /*
@@ -229,55 +1082,165 @@ void aggregate_plurality_data(cittadino citizen, contatore **counters) {
  * @param citizen La struttura del cittadino.
  * @param condorcet_matrix La matrice Condorcet da aggiornare.
  * @param num_projects Numero totale di progetti.
+ * @param weight Numero di cittadini con questa scheda.
  */
-void aggregate_condorcet_data(cittadino citizen, vint *condorcet_matrix, int num_projects) {
-	int i,j,l;
-    for (i = 0; i < num_projects; ++i) {
-        for (j = i + 1; j < num_projects; ++j) {
-            /* Trova la posizione relativa di persona.progs[i] e persona.progs[j] nelle preferenze */
-            /* Se persona.progs[i]  preferito a persona.progs[j] */
-            /* Incrementa matrice[persona.progs[i]][persona.progs[j]] */
-            /* Questa logica dipende dalla struttura esatta di 'op' e 'progs'. */
-            if (citizen.pref[i] != '=') { /* Se non c' parit con il progetto precedente */
-                condorcet_matrix[citizen.progs[i]][citizen.progs[j]]++;
-            } else { /* Se c' parit */
-                int k = i;
-                /* Trova il primo progetto non in parit con persona.progs[i] */
-                while (k < num_projects - 1 && citizen.pref[k] == '=') {
-                    k++;
-                }
-                /* Tutti i progetti da persona.progs[i] fino a k (esclusi) sono in parit. */
-                /* Incrementa la preferenza per persona.progs[i] vs tutti i progetti successivi a k. */
-                for (l = k; l < num_projects; ++l) {
-                    condorcet_matrix[citizen.progs[i]][citizen.progs[l]]++;
-                }
+void aggregate_condorcet_data(cittadino citizen, Matrice *condorcet_matrix, int num_projects, int weight) {
+    cittadino *ballot = &citizen;
+    aggregate_condorcet_ballots(&ballot, &weight, 1, condorcet_matrix, num_projects);
+}
+
+/*
+ * @brief Aggrega nella matrice Condorcet un insieme di schede pesate, a blocchi di CONDORCET_BLOCCO.
+ * @param ballots Le schede (tutte con la stessa larghezza degli indici).
+ * @param weights Numero di cittadini di ciascuna scheda.
+ * @param num_ballots Numero di schede.
+ * @param condorcet_matrix La matrice Condorcet da aggiornare.
+ * @param num_projects Numero totale di progetti.
+ */
+void aggregate_condorcet_ballots(cittadino **ballots, const int *weights, int num_ballots, Matrice *condorcet_matrix, int num_projects) {
+    int first, count;
+    size_t block_cells = (size_t)CONDORCET_BLOCCO * num_projects;
+    void *positions;
+    int *thresholds, *amounts;
+    if (num_ballots <= 0) {
+        return;
+    }
+    positions = malloc(block_cells * ballots[0]->larghezza);
+    thresholds = (int *)malloc(block_cells * sizeof(int));
+    amounts = (int *)malloc(block_cells * sizeof(int));
+    if (!positions || !thresholds || !amounts) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per lo spazio di lavoro del metodo Condorcet.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (first = 0; first < num_ballots; first += CONDORCET_BLOCCO) {
+        count = num_ballots - first < CONDORCET_BLOCCO ? num_ballots - first : CONDORCET_BLOCCO;
+        switch (ballots[0]->larghezza) {
+            case 1: condorcet_block_u8(ballots + first, weights + first, count, condorcet_matrix, num_projects,
+                                       (unsigned char *)positions, thresholds, amounts); break;
+            case 2: condorcet_block_u16(ballots + first, weights + first, count, condorcet_matrix, num_projects,
+                                        (unsigned short *)positions, thresholds, amounts); break;
+            default: condorcet_block_i32(ballots + first, weights + first, count, condorcet_matrix, num_projects,
+                                         (int *)positions, thresholds, amounts); break;
+        }
+    }
+    free(positions);
+    free(thresholds);
+    free(amounts);
+}
+
+/*
+ * @brief Raccoglie pluralita', righe Borda e matrice Condorcet per un insieme di schede pesate, su piu' thread.
+ * Ogni thread elabora un intervallo contiguo di schede con contatori e matrice Condorcet privati; le righe
+ * Borda sono per scheda e vengono scritte sul posto. I parziali vengono poi sommati in ordine di thread,
+ * quindi il risultato coincide con quello dell'esecuzione seriale.
+ * @param ballots Le schede (riga i della matrice Borda per la scheda i).
+ * @param weights Numero di cittadini di ciascuna scheda.
+ * @param num_ballots Numero di schede.
+ * @param counters Contatori di pluralita' da aggiornare.
+ * @param borda_matrix La matrice Borda da popolare.
+ * @param condorcet_matrix La matrice Condorcet da aggiornare.
+ * @param num_projects Numero totale di progetti.
+ * @param num_workers Numero massimo di thread (1 = seriale).
+ */
+void aggregate_ballots(cittadino **ballots, const int *weights, int num_ballots, contatore **counters,
+                       Matrice *borda_matrix, Matrice *condorcet_matrix, int num_projects, int num_workers) {
+    LavoroAggregazione job;
+    int w, i, j;
+
+    /* Niente thread in piu' delle porzioni di lavoro che valgono la pena */
+    if (num_workers > (num_ballots + AGGREGAZIONE_SCHEDE_PER_THREAD - 1) / AGGREGAZIONE_SCHEDE_PER_THREAD) {
+        num_workers = (num_ballots + AGGREGAZIONE_SCHEDE_PER_THREAD - 1) / AGGREGAZIONE_SCHEDE_PER_THREAD;
+    }
+    if (num_workers < 1) {
+        num_workers = 1;
+    }
+
+    job.ballots = ballots;
+    job.weights = weights;
+    job.num_ballots = num_ballots;
+    job.num_projects = num_projects;
+    job.borda = borda_matrix;
+    job.counters = (contatore ***)calloc(num_workers, sizeof(contatore **));
+    job.condorcet = (Matrice *)calloc(num_workers, sizeof(Matrice));
+    if (!job.counters || !job.condorcet) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per i parziali della raccolta dati.\n");
+        exit(EXIT_FAILURE);
+    }
+    job.counters[0] = counters;
+    job.condorcet[0] = *condorcet_matrix; /* Stesso blocco: il thread 0 scrive direttamente nel risultato */
+    for (w = 1; w < num_workers; ++w) {
+        job.counters[w] = initialize_counter_array(num_projects);
+        allocate_matrix(&job.condorcet[w], num_projects, num_projects, (int)sizeof(int));
+    }
+
+    run_parallel(num_workers, aggregate_ballot_range, &job);
+
+    /* Riduzione in ordine fisso di thread */
+    for (w = 1; w < num_workers; ++w) {
+        for (j = 0; j < num_projects; ++j) {
+            counters[j]->cont += job.counters[w][j]->cont;
+            free(job.counters[w][j]);
+        }
+        for (i = 0; i < num_projects; ++i) {
+            int *row = MATRICE_INT(condorcet_matrix, i);
+            const int *partial = MATRICE_INT(&job.condorcet[w], i);
+            for (j = 0; j < num_projects; ++j) {
+                row[j] += partial[j];
             }
         }
+        free(job.counters[w]);
+        free_matrix(&job.condorcet[w]);
     }
+    free(job.counters);
+    free(job.condorcet);
+}
+
+/*
+ * @brief Lavoro di un thread della raccolta dati: elabora l'intervallo di schede che gli spetta.
+ * @param context Il LavoroAggregazione condiviso.
+ * @param worker Indice del thread.
+ * @param num_workers Numero totale di thread.
+ */
+static void aggregate_ballot_range(void *context, int worker, int num_workers) {
+    LavoroAggregazione *job = (LavoroAggregazione *)context;
+    int first = (int)((long)job->num_ballots * worker / num_workers);
+    int last = (int)((long)job->num_ballots * (worker + 1) / num_workers);
+    int i;
+    for (i = first; i < last; ++i) {
+        aggregate_plurality_data(*job->ballots[i], job->counters[worker], job->weights[i], job->num_projects);
+        insert_borda_scores(*job->ballots[i], i, job->borda, job->num_projects);
+    }
+    aggregate_condorcet_ballots(job->ballots + first, job->weights + first, last - first, &job->condorcet[worker], job->num_projects);
 }
 
 /*
  * @brief Inserisce i punteggi Borda di un cittadino nella matrice Borda.
  * @param citizen La struttura del cittadino.
- * @param citizen_idx L'indice del cittadino nella matrice.
+ * @param citizen_idx L'indice della riga nella matrice (cittadino o classe di schede).
  * @param borda_matrix La matrice Borda da popolare.
  * @param num_projects Numero totale di progetti.
  */
-void insert_borda_scores(cittadino citizen, int citizen_idx, vint *borda_matrix, int num_projects) {
-    int project_iter = 0;
-    int current_points = num_projects; /* Inizia con il massimo dei punti (num_projects per la prima posizione) */
+void insert_borda_scores(cittadino citizen, int citizen_idx, Matrice *borda_matrix, int num_projects) {
+    void *row = MATRICE_RIGA(borda_matrix, citizen_idx);
+    switch (citizen.larghezza) {
+        case 1: borda_row_u8(citizen.progs.u8, citizen.pref, (unsigned char *)row, num_projects); break;
+        case 2: borda_row_u16(citizen.progs.u16, citizen.pref, (unsigned short *)row, num_projects); break;
+        default: borda_row_i32(citizen.progs.i32, citizen.pref, (int *)row, num_projects); break;
+    }
+}
 
-    do {
-        int start_group_idx = project_iter;
-        /* Trova tutti i progetti con lo stesso ranking (legati da '=') */
-        while (project_iter < num_projects && (project_iter == start_group_idx || citizen.pref[project_iter - 1] == '=')) {
-            /* Assegna lo stesso punteggio a tutti i progetti con lo stesso ranking */
-            borda_matrix[citizen_idx][citizen.progs[project_iter]] = current_points;
-            project_iter++;
-        }
-        /* I punti per il prossimo gruppo di progetti sono 'num_projects' meno il numero di progetti gi assegnati */
-        current_points = num_projects - project_iter;
-    } while (current_points >= 1 && project_iter < num_projects); /* Continua finch ci sono punti da assegnare e progetti */
+/*
+ * @brief Somma i punteggi Borda di un cittadino ai totali per progetto, senza memorizzarne la riga.
+ * @param citizen La struttura del cittadino.
+ * @param borda_totals Punteggi totali per progetto da aggiornare.
+ * @param num_projects Numero totale di progetti.
+ */
+void accumulate_borda_scores(cittadino citizen, vint borda_totals, int num_projects) {
+    switch (citizen.larghezza) {
+        case 1: borda_totals_u8(citizen.progs.u8, citizen.pref, borda_totals, num_projects); break;
+        case 2: borda_totals_u16(citizen.progs.u16, citizen.pref, borda_totals, num_projects); break;
+        default: borda_totals_i32(citizen.progs.i32, citizen.pref, borda_totals, num_projects); break;
+    }
 }
 
 /* Funzioni ausiliarie e di stampa */
@@ -327,7 +1290,7 @@ void display_method_results(contatore **counters, vchar *project_names, int num_
 void print_cluster_output(componente **min_components, cittadino **citizens_data, int num_citizens, int num_actual_groups) {
     /* Allocate memory for group distance sums, plus an element for the total sum (index 0) */
     int group_idx, representative_identifier, current_component_index;
-    int *group_sums = (int *)calloc(num_actual_groups + 1, sizeof(int)); /* +1 for total_sum at sums[0] */
+    long *group_sums = (long *)calloc(num_actual_groups + 1, sizeof(long)); /* +1 for total_sum at sums[0]; long, like the -S costs */
     if (!group_sums) {
         fprintf(stderr, "ERROR: Failed to allocate memory for group sum array.\n");
         exit(EXIT_FAILURE);
@@ -346,14 +1309,14 @@ void print_cluster_output(componente **min_components, cittadino **citizens_data
         }
     }
 
-    printf("Gruppi (%d)\n", group_sums[0]); /* Print the total sum of distances */
+    printf("Gruppi (%ld)\n", group_sums[0]); /* Print the total sum of distances */
 
     current_component_index = 0; /* Reset index for the printing phase */
     
     /* Print the details of each group */
     for (group_idx = 1; group_idx <= num_actual_groups; ++group_idx) {
         	representative_identifier = min_components[current_component_index]->rappr;
-        printf("%s (%d) ", citizens_data[representative_identifier]->CF, group_sums[group_idx]);
+        printf("%s (%ld) ", citizens_data[representative_identifier]->CF, group_sums[group_idx]);
         
         /* Print members of the current group */
         for (; current_component_index < num_citizens && min_components[current_component_index]->rappr == representative_identifier; ++current_component_index) {
@@ -369,6 +1332,20 @@ void print_cluster_output(componente **min_components, cittadino **citizens_data
     free(group_sums); /* Free the allocated memory */
 }
 
+/*
+ * @brief Stampa la curva costo/numero di gruppi del clustering incrementale.
+ * @param group_costs Costo totale con k gruppi all'indice k (da 1 a num_groups).
+ * @param num_groups Numero di gruppi raggiunti.
+ */
+void print_cost_curve(const long *group_costs, int num_groups) {
+    int k;
+    printf("Costo per numero di gruppi\n");
+    for (k = 1; k <= num_groups; ++k) {
+        printf("%d %ld\n", k, group_costs[k]);
+    }
+    printf("\n");
+}
+
 
 /* ------------------------------Ausiliarie------------------------------ */
 
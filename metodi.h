@@ -9,6 +9,20 @@
 #include "sort.h" 
 #include "grafo.h"   /* Doxygen++; :) */
 
+/* Massimo di cittadini estratti per campione dal clustering a campionamento (le distanze del campione sono quadratiche) */
+#ifndef CLARA_CAMPIONE_MASSIMO
+#define CLARA_CAMPIONE_MASSIMO 10000
+#endif
+
+/**
+ * Conteggio delle distanze calcolate ed evitate (grazie alla disuguaglianza triangolare) nelle assegnazioni
+ * dei cittadini ai rappresentanti del clustering.
+ */
+typedef struct {
+    long valutate;
+    long evitate;
+} StatistichePotatura;
+
 /* Metodi di votazione e procedure di preparazione dati */
 
 /**
@@ -21,13 +35,23 @@ void calculate_and_display_plurality(contatore **counters, vchar *project_names,
 
 /**
  * @brief Calculates Borda method scores and displays the results.
- * @param borda_matrix Borda score matrix per citizen.
+ * @param borda_matrix Borda score matrix per ballot class (elements at the rank width).
+ * @param weights Number of citizens in each ballot class (matrix row).
+ * @param counters Array of counters for projects.
+ * @param project_names Array of project names.
+ * @param num_rows Number of matrix rows (ballot classes).
+ * @param num_projects Number of projects.
+ */
+void calculate_and_display_borda(const Matrice *borda_matrix, const int *weights, contatore **counters, vchar *project_names, int num_rows, int num_projects);
+
+/**
+ * @brief Displays Borda method results from already accumulated per-project totals.
+ * @param borda_totals Total Borda score of each project.
  * @param counters Array of counters for projects.
  * @param project_names Array of project names.
- * @param num_citizens Number of citizens.
  * @param num_projects Number of projects.
  */
-void calculate_and_display_borda(vint *borda_matrix, contatore **counters, vchar *project_names, int num_citizens, int num_projects);
+void calculate_and_display_borda_totals(vint borda_totals, contatore **counters, vchar *project_names, int num_projects);
 
 /**
  * @brief Calculates Condorcet method results and displays the winner/order.
@@ -36,18 +60,74 @@ void calculate_and_display_borda(vint *borda_matrix, contatore **counters, vchar
  * @param project_names Array of project names.
  * @param num_projects Number of projects.
  */
-void calculate_and_display_condorcet(vint *condorcet_matrix, contatore **counters, vchar *project_names, int num_projects);
+void calculate_and_display_condorcet(const Matrice *condorcet_matrix, contatore **counters, vchar *project_names, int num_projects);
 
 /**
  * @brief Executes the greedy clustering algorithm and prints the resulting groups.
- * @param borda_scores_matrix Borda scores matrix (used to calculate distances).
- * @param distance_matrix Distance matrix between citizens.
+ * Works on weighted ballot classes; the groups are still printed per citizen.
+ * @param borda_scores_matrix Borda scores matrix per ballot class (used to calculate distances).
+ * @param distance_store Distances between ballot classes (packed upper triangle), filled here.
+ *        When it has no data (over the memory budget) each row is recomputed from the Borda matrix instead.
+ * @param ballot_classes Classes of identical ballots.
  * @param num_citizens Number of citizens.
  * @param num_projects Number of projects.
  * @param desired_groups Number of desired groups.
  * @param citizens_data Array of citizen structures.
+ * @param num_workers Maximum number of threads for the distance computation (1 = serial).
+ * @param stats If not NULL, receives the distances evaluated and those skipped by the triangle inequality
+ *        while updating assignments after each new representative.
  */
-void perform_greedy_clustering(vint *borda_scores_matrix, vint *distance_matrix, int num_citizens, int num_projects, int desired_groups, cittadino **citizens_data);
+void perform_greedy_clustering(const Matrice *borda_scores_matrix, DistanzeTriangolari *distance_store, const ClassiSchede *ballot_classes, int num_citizens, int num_projects, int desired_groups, cittadino **citizens_data,
+                               int num_workers, StatistichePotatura *stats);
+
+/**
+ * @brief Incremental greedy clustering: adds one representative at a time up to max_groups, records the total
+ * distance of the citizens from their representatives after each one and prints the full groups only for the
+ * requested k. The groups printed for k are those perform_greedy_clustering prints with desired_groups = k,
+ * so a whole cost-vs-groups curve costs one run instead of one run per k.
+ * @param borda_scores_matrix Borda scores matrix per ballot class (used to calculate distances).
+ * @param distance_store Distances between ballot classes (packed upper triangle), filled here.
+ * @param ballot_classes Classes of identical ballots.
+ * @param num_citizens Number of citizens.
+ * @param num_projects Number of projects.
+ * @param max_groups Maximum number of groups (at least 1).
+ * @param print_at max_groups + 1 flags: the groups for k representatives are printed when print_at[k] is not 0.
+ *        If the distinct ballots run out before max_groups, requested k past the last one print the final groups once.
+ * @param citizens_data Array of citizen structures.
+ * @param num_workers Maximum number of threads for the distance computation (1 = serial).
+ * @param group_costs If not NULL, max_groups + 1 elements: group_costs[k] receives the total distance with k groups.
+ * @param stats If not NULL, receives the distances evaluated and those skipped by the triangle inequality.
+ * @return The number of groups reached (less than max_groups when there are fewer distinct ballots).
+ */
+int perform_greedy_sweep(const Matrice *borda_scores_matrix, DistanzeTriangolari *distance_store, const ClassiSchede *ballot_classes, int num_citizens, int num_projects, int max_groups,
+                         const char *print_at, cittadino **citizens_data, int num_workers, long *group_costs, StatistichePotatura *stats);
+
+/**
+ * @brief Prints the total distance for each number of groups reached by perform_greedy_sweep.
+ * @param group_costs Total distance with k groups at index k (1 to num_groups).
+ * @param num_groups Number of groups reached.
+ */
+void print_cost_curve(const long *group_costs, int num_groups);
+
+/**
+ * @brief Sampling-based k-medoids clustering (CLARA with CLARANS local search) for very large electorates.
+ * Draws CLARA_CAMPIONI random samples of citizens, picks medoids on each sample with the greedy rule,
+ * refines them with random medoid swaps and keeps the set with the lowest cost on the whole electorate.
+ * Every citizen is then assigned to its nearest medoid in one O(V*K*P) pass; the groups are printed in the
+ * same format as perform_greedy_clustering. No pairwise distance store is needed.
+ * @param borda_scores_matrix Borda scores matrix per ballot class.
+ * @param ballot_classes Classes of identical ballots.
+ * @param num_citizens Number of citizens.
+ * @param num_projects Number of projects.
+ * @param desired_groups Number of desired groups.
+ * @param citizens_data Array of citizen structures.
+ * @param sample_size Citizens drawn per sample (1 to CLARA_CAMPIONE_MASSIMO).
+ * @param seed Pseudo-random seed: the same seed and input give the same groups.
+ * @param stats If not NULL, receives the distances evaluated and those skipped by the triangle inequality
+ *        in the medoid assignments.
+ */
+void perform_sampled_clustering(const Matrice *borda_scores_matrix, const ClassiSchede *ballot_classes, int num_citizens, int num_projects, int desired_groups,
+                                cittadino **citizens_data, int sample_size, unsigned long seed, StatistichePotatura *stats);
 
 /* Functions for data collection by methods */
 
@@ -55,25 +135,63 @@ void perform_greedy_clustering(vint *borda_scores_matrix, vint *distance_matrix,
  * @brief Aggregates a citizen's preference data for the plurality method.
  * @param citizen The citizen's structure whose preferences are to be added.
  * @param counters Array of counters to update.
+ * @param weight Number of citizens sharing this ballot.
+ * @param num_projects Number of projects (ballot length).
+ */
+void aggregate_plurality_data(cittadino citizen, contatore **counters, int weight, int num_projects);
+
+/**
+ * @brief Collects plurality counts, Borda rows and the Condorcet matrix for a set of weighted ballots, on several threads.
+ * Each thread owns its plurality counters and Condorcet matrix; partial results are summed in thread order,
+ * so the output is identical to a serial run.
+ * @param ballots The ballots (Borda matrix row i belongs to ballot i).
+ * @param weights Number of citizens sharing each ballot.
+ * @param num_ballots Number of ballots.
+ * @param counters Plurality counters to update.
+ * @param borda_matrix The Borda matrix to populate.
+ * @param condorcet_matrix The Condorcet matrix to update.
+ * @param num_projects Total number of projects.
+ * @param num_workers Maximum number of threads (1 = serial).
  */
-void aggregate_plurality_data(cittadino citizen, contatore **counters);
+void aggregate_ballots(cittadino **ballots, const int *weights, int num_ballots, contatore **counters,
+                       Matrice *borda_matrix, Matrice *condorcet_matrix, int num_projects, int num_workers);
 
 /**
  * @brief Inserts a citizen's Borda scores into the Borda matrix.
  * @param citizen The citizen's structure.
- * @param citizen_idx The citizen's index in the matrix.
+ * @param citizen_idx The matrix row (citizen or ballot class).
  * @param borda_matrix The Borda matrix to populate.
  * @param num_projects Total number of projects.
  */
-void insert_borda_scores(cittadino citizen, int citizen_idx, vint *borda_matrix, int num_projects);
+void insert_borda_scores(cittadino citizen, int citizen_idx, Matrice *borda_matrix, int num_projects);
+
+/**
+ * @brief Adds a citizen's Borda scores to the per-project totals without storing the row.
+ * @param citizen The citizen's structure.
+ * @param borda_totals Per-project totals to update.
+ * @param num_projects Total number of projects.
+ */
+void accumulate_borda_scores(cittadino citizen, vint borda_totals, int num_projects);
 
 /**
  * @brief Aggregates a citizen's preference data for the Condorcet method.
  * @param citizen The citizen's structure.
  * @param condorcet_matrix The Condorcet matrix to update.
  * @param num_projects Total number of projects.
+ * @param weight Number of citizens sharing this ballot.
+ */
+void aggregate_condorcet_data(cittadino citizen, Matrice *condorcet_matrix, int num_projects, int weight);
+
+/**
+ * @brief Aggregates a set of weighted ballots into the Condorcet matrix, processing them in blocks.
+ * Gives exactly the same matrix as calling aggregate_condorcet_data on each ballot.
+ * @param ballots The ballots (all with the same rank width).
+ * @param weights Number of citizens sharing each ballot.
+ * @param num_ballots Number of ballots.
+ * @param condorcet_matrix The Condorcet matrix to update.
+ * @param num_projects Total number of projects.
  */
-void aggregate_condorcet_data(cittadino citizen, vint *condorcet_matrix, int num_projects);
+void aggregate_condorcet_ballots(cittadino **ballots, const int *weights, int num_ballots, Matrice *condorcet_matrix, int num_projects);
 
 /* Auxiliary and printing functions */
 
@@ -0,0 +1,163 @@
+/*
+ * Kernel dei metodi specializzati per la larghezza degli indici di progetto e dei punteggi Borda.
+ * Questo file non ha include guard: metodi.c lo include una volta per larghezza dopo aver definito
+ *   RANK_T        il tipo degli elementi (unsigned char, unsigned short o int);
+ *   KERNEL(nome)  il nome della funzione specializzata (es. nome##_u8);
+ *   KERNEL_L1     il campo di KernelDistanzaL1 per questa larghezza (u8, u16 o i32).
+ * Le funzioni pubbliche di metodi.c scelgono la versione giusta in base a 'larghezza'.
+ */
+
+/*
+ * @brief Aggiunge il voto di pluralita' di un cittadino (primo gruppo di progetti a pari merito).
+ * @param progs Indici dei progetti in ordine di preferenza.
+ * @param pref Simboli di preferenza tra progetti consecutivi.
+ * @param counters Array di contatori da aggiornare.
+ * @param weight Numero di cittadini con questa scheda.
+ * @param num_projects Numero di progetti della scheda: i simboli delle schede sono contigui nell'archivio,
+ *        quindi una scheda tutta a pari merito non deve proseguire nella riga successiva.
+ */
+static void KERNEL(plurality)(const RANK_T *progs, const char *pref, contatore **counters, int weight, int num_projects) {
+    int i = 0;
+    do {
+        counters[progs[i]]->cont += weight; /* Incrementa il conteggio per il progetto preferito */
+        i++;
+    } while (i < num_projects && pref[i - 1] == '='); /* Continua se ci sono preferenze pari */
+}
+
+/*
+ * @brief Aggiunge alla matrice Condorcet le preferenze a coppie di un blocco di schede pesate.
+ * Per ogni scheda si costruisce prima il vettore delle posizioni (posizione di ciascun progetto) e, per
+ * ciascun progetto a in posizione i, la soglia e il peso del suo contributo:
+ * - se a non e' in parita' con il successivo: +peso su M[a][b] per ogni b in posizione > i;
+ * - altrimenti, detta k la prima posizione >= i non in parita' con la successiva (al piu' l'ultima),
+ *   +peso * (num_projects - 1 - i) su M[a][b] per ogni b in posizione >= k.
+ * E' esattamente cio' che somma la scansione per coppie (i, j) con le sue regole di parita'.
+ * La riga M[a] viene poi aggiornata per tutte le schede del blocco, senza salti e con accessi contigui.
+ * @param ballots Le schede del blocco.
+ * @param weights Peso di ciascuna scheda (cittadini che la condividono).
+ * @param count Numero di schede nel blocco.
+ * @param condorcet_matrix La matrice Condorcet da aggiornare.
+ * @param num_projects Numero totale di progetti.
+ * @param positions Spazio di lavoro: count x num_projects posizioni.
+ * @param thresholds Spazio di lavoro: count x num_projects soglie.
+ * @param amounts Spazio di lavoro: count x num_projects contributi.
+ */
+static void KERNEL(condorcet_block)(cittadino **ballots, const int *weights, int count, Matrice *condorcet_matrix, int num_projects,
+                                    RANK_T *positions, int *thresholds, int *amounts) {
+    int t, i, a, b, next_break;
+    for (t = 0; t < count; ++t) {
+        const RANK_T *progs = (const RANK_T *)ballots[t]->progs.dati;
+        const char *pref = ballots[t]->pref;
+        RANK_T *position = positions + (size_t)t * num_projects;
+        int *threshold = thresholds + (size_t)t * num_projects;
+        int *amount = amounts + (size_t)t * num_projects;
+        next_break = num_projects - 1;
+        for (i = num_projects - 1; i >= 0; --i) {
+            a = progs[i];
+            position[a] = (RANK_T)i;
+            if (i == num_projects - 1 || pref[i] != '=') { /* pref[num_projects - 1] non appartiene alla scheda */
+                next_break = i;
+                threshold[a] = i + 1;
+                amount[a] = weights[t];
+            } else {
+                threshold[a] = next_break;
+                amount[a] = weights[t] * (num_projects - 1 - i);
+            }
+        }
+    }
+    for (a = 0; a < num_projects; ++a) {
+        int *row = MATRICE_INT(condorcet_matrix, a);
+        for (t = 0; t < count; ++t) {
+            const RANK_T *position = positions + (size_t)t * num_projects;
+            int threshold = thresholds[(size_t)t * num_projects + a];
+            int amount = amounts[(size_t)t * num_projects + a];
+            if (threshold >= num_projects) {
+                continue; /* Ultimo progetto della scheda: nessuno dopo di lui */
+            }
+            for (b = 0; b < num_projects; ++b) {
+                row[b] += amount * (position[b] >= threshold);
+            }
+        }
+    }
+}
+
+/*
+ * @brief Calcola i punteggi Borda di un cittadino e li scrive in una riga della matrice Borda.
+ * @param progs Indici dei progetti in ordine di preferenza.
+ * @param pref Simboli di preferenza tra progetti consecutivi.
+ * @param row Riga della matrice indicizzata per progetto (punteggi <= num_projects).
+ * @param num_projects Numero totale di progetti.
+ */
+static void KERNEL(borda_row)(const RANK_T *progs, const char *pref, RANK_T *row, int num_projects) {
+    int project_iter = 0;
+    int current_points = num_projects; /* Inizia con il massimo dei punti (num_projects per la prima posizione) */
+
+    do {
+        int start_group_idx = project_iter;
+        /* Trova tutti i progetti con lo stesso ranking (legati da '=') */
+        while (project_iter < num_projects && (project_iter == start_group_idx || pref[project_iter - 1] == '=')) {
+            row[progs[project_iter]] = (RANK_T)current_points;
+            project_iter++;
+        }
+        /* I punti per il prossimo gruppo di progetti sono 'num_projects' meno il numero di progetti gi assegnati */
+        current_points = num_projects - project_iter;
+    } while (current_points >= 1 && project_iter < num_projects);
+}
+
+/*
+ * @brief Somma i punteggi Borda di un cittadino ai totali per progetto.
+ * @param progs Indici dei progetti in ordine di preferenza.
+ * @param pref Simboli di preferenza tra progetti consecutivi.
+ * @param borda_totals Punteggi totali per progetto da aggiornare.
+ * @param num_projects Numero totale di progetti.
+ */
+static void KERNEL(borda_totals)(const RANK_T *progs, const char *pref, vint borda_totals, int num_projects) {
+    int project_iter = 0;
+    int current_points = num_projects;
+
+    do {
+        int start_group_idx = project_iter;
+        while (project_iter < num_projects && (project_iter == start_group_idx || pref[project_iter - 1] == '=')) {
+            borda_totals[progs[project_iter]] += current_points;
+            project_iter++;
+        }
+        current_points = num_projects - project_iter;
+    } while (current_points >= 1 && project_iter < num_projects);
+}
+
+/*
+ * @brief Somma per colonna la matrice Borda nei contatori dei progetti, pesando ogni riga.
+ * @param borda_matrix Matrice Borda (una riga per classe di schede).
+ * @param weights Peso di ciascuna riga.
+ * @param counters Contatori dei progetti, gia' azzerati.
+ * @param num_rows Numero di righe.
+ * @param num_projects Numero di colonne.
+ */
+static void KERNEL(borda_column_sums)(const Matrice *borda_matrix, const int *weights, contatore **counters, int num_rows, int num_projects) {
+    int i, j;
+    for (i = 0; i < num_rows; ++i) {
+        const RANK_T *row = (const RANK_T *)MATRICE_RIGA(borda_matrix, i);
+        for (j = 0; j < num_projects; ++j) {
+            counters[j]->cont += weights[i] * row[j]; /* Somma i punteggi Borda per ciascun progetto */
+        }
+    }
+}
+
+/*
+ * @brief Calcola le distanze (Manhattan, o norma L1) dalla riga Borda i alle righe da first in poi.
+ * @param borda_matrix Matrice Borda.
+ * @param i La riga di partenza.
+ * @param first La prima riga di arrivo.
+ * @param num_rows Numero di righe.
+ * @param num_projects Numero di progetti.
+ * @param distances Distanze da i a j in posizione j - first.
+ * @param l1 Kernel della distanza tra due righe (vettoriale se la CPU lo consente).
+ */
+static void KERNEL(distance_row)(const Matrice *borda_matrix, int i, int first, int num_rows, int num_projects, int *distances,
+                                 const KernelDistanzaL1 *l1) {
+    int j;
+    const RANK_T *row_i = (const RANK_T *)MATRICE_RIGA(borda_matrix, i);
+    for (j = first; j < num_rows; ++j) {
+        distances[j - first] = l1->KERNEL_L1(row_i, (const RANK_T *)MATRICE_RIGA(borda_matrix, j), num_projects);
+    }
+}
@@ -0,0 +1,169 @@
+/* pthread e sysconf non sono visibili compilando in modalita' C89 stretta senza questa macro */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "parallelo.h"      /* Doxygen++; :) */
+
+#if ELEZIONI_THREADS
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * @brief Argomento passato a ciascun thread POSIX.
+ */
+typedef struct {
+    lavoro_parallelo job;
+    void *context;
+    int worker;
+    int num_workers;
+} ArgomentoThread;
+
+/**
+ * @brief Stato condiviso di run_parallel_tasks: il prossimo compito libero, protetto da un mutex.
+ */
+typedef struct {
+    compito_parallelo task;
+    void *context;
+    int num_tasks;
+    int next_task;
+    pthread_mutex_t lock;
+} CodaCompiti;
+
+/**
+ * @brief Punto di ingresso dei thread: adatta la firma di pthread a quella di lavoro_parallelo.
+ * @param arg Puntatore a ArgomentoThread.
+ * @return Sempre NULL.
+ */
+static void *thread_entry(void *arg) {
+    ArgomentoThread *argument = (ArgomentoThread *)arg;
+    argument->job(argument->context, argument->worker, argument->num_workers);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Restituisce il numero di processori disponibili (1 se non determinabile o senza thread).
+ * @return Il numero di thread di lavoro suggerito.
+ */
+int available_workers(void) {
+#if ELEZIONI_THREADS && defined(_SC_NPROCESSORS_ONLN)
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online < 1) {
+        return 1;
+    }
+    return online > MAX_WORKERS ? MAX_WORKERS : (int)online;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Esegue 'job' su 'num_workers' thread e attende che terminino tutti.
+ * @param num_workers Numero di thread di lavoro (almeno 1).
+ * @param job La funzione da eseguire.
+ * @param context Dati condivisi passati a ogni thread.
+ */
+void run_parallel(int num_workers, lavoro_parallelo job, void *context) {
+#if ELEZIONI_THREADS
+    pthread_t *threads;
+    ArgomentoThread *arguments;
+    int *started;
+    int w;
+
+    if (num_workers <= 1) {
+        job(context, 0, 1);
+        return;
+    }
+    threads = (pthread_t *)calloc(num_workers, sizeof(pthread_t));
+    arguments = (ArgomentoThread *)calloc(num_workers, sizeof(ArgomentoThread));
+    started = (int *)calloc(num_workers, sizeof(int));
+    if (!threads || !arguments || !started) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per i thread di lavoro.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (w = 0; w < num_workers; ++w) {
+        arguments[w].job = job;
+        arguments[w].context = context;
+        arguments[w].worker = w;
+        arguments[w].num_workers = num_workers;
+    }
+    for (w = 1; w < num_workers; ++w) {
+        started[w] = (pthread_create(&threads[w], NULL, thread_entry, &arguments[w]) == 0);
+    }
+    job(context, 0, num_workers);
+    for (w = 1; w < num_workers; ++w) {
+        if (started[w]) {
+            pthread_join(threads[w], NULL);
+        } else {
+            /* Thread non creato (risorse esaurite): il suo lavoro viene svolto dal chiamante */
+            job(context, w, num_workers);
+        }
+    }
+    free(threads);
+    free(arguments);
+    free(started);
+#else
+    int w;
+    for (w = 0; w < num_workers; ++w) {
+        job(context, w, num_workers);
+    }
+#endif
+}
+
+#if ELEZIONI_THREADS
+/**
+ * @brief Lavoro di ciascun thread di run_parallel_tasks: preleva ed esegue compiti finche' ne restano.
+ * @param context Puntatore a CodaCompiti.
+ * @param worker Indice del thread.
+ * @param num_workers Numero totale di thread (non usato).
+ */
+static void take_tasks(void *context, int worker, int num_workers) {
+    CodaCompiti *queue = (CodaCompiti *)context;
+    (void)num_workers;
+    for (;;) {
+        int current;
+        pthread_mutex_lock(&queue->lock);
+        current = queue->next_task < queue->num_tasks ? queue->next_task++ : -1;
+        pthread_mutex_unlock(&queue->lock);
+        if (current < 0) {
+            return;
+        }
+        queue->task(queue->context, current, worker);
+    }
+}
+#endif
+
+/**
+ * @brief Esegue 'num_tasks' compiti su 'num_workers' thread con distribuzione dinamica.
+ * @param num_workers Numero di thread di lavoro (almeno 1).
+ * @param num_tasks Numero di compiti.
+ * @param task La funzione da eseguire per ciascun compito.
+ * @param context Dati condivisi passati a ogni compito.
+ */
+void run_parallel_tasks(int num_workers, int num_tasks, compito_parallelo task, void *context) {
+#if ELEZIONI_THREADS
+    CodaCompiti queue;
+    if (num_workers > num_tasks) {
+        num_workers = num_tasks;
+    }
+    if (num_workers > 1) {
+        queue.task = task;
+        queue.context = context;
+        queue.num_tasks = num_tasks;
+        queue.next_task = 0;
+        if (pthread_mutex_init(&queue.lock, NULL) == 0) {
+            run_parallel(num_workers, take_tasks, &queue);
+            pthread_mutex_destroy(&queue.lock);
+            return;
+        }
+    }
+#endif
+    {
+        int t;
+        (void)num_workers;
+        for (t = 0; t < num_tasks; ++t) {
+            task(context, t, 0);
+        }
+    }
+}
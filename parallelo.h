@@ -0,0 +1,66 @@
+#ifndef __parallelo_h
+#define __parallelo_h
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Doxygen++; :) */
+
+/* I thread POSIX sono usati dove disponibili; compilare con -DELEZIONI_THREADS=0 per forzare l'esecuzione seriale */
+#ifndef ELEZIONI_THREADS
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#define ELEZIONI_THREADS 1
+#else
+#define ELEZIONI_THREADS 0
+#endif
+#endif
+
+/* Numero massimo di thread di lavoro accettati */
+#ifndef MAX_WORKERS
+#define MAX_WORKERS 256
+#endif
+
+/**
+ * @brief Funzione eseguita da ciascun thread di lavoro.
+ * @param context Dati condivisi tra i thread.
+ * @param worker Indice del thread, da 0 a num_workers - 1.
+ * @param num_workers Numero totale di thread.
+ */
+typedef void (*lavoro_parallelo)(void *context, int worker, int num_workers);
+
+/**
+ * @brief Funzione che esegue un singolo compito di un lavoro a distribuzione dinamica.
+ * @param context Dati condivisi tra i thread.
+ * @param task Indice del compito, da 0 a num_tasks - 1.
+ * @param worker Indice del thread che lo esegue (per gli spazi di lavoro privati).
+ */
+typedef void (*compito_parallelo)(void *context, int task, int worker);
+
+/**
+ * @brief Restituisce il numero di processori disponibili (1 se non determinabile o senza thread).
+ * @return Il numero di thread di lavoro suggerito.
+ */
+int available_workers(void);
+
+/**
+ * @brief Esegue 'job' su 'num_workers' thread e attende che terminino tutti.
+ * Il thread chiamante esegue il lavoro di indice 0. Senza supporto ai thread i lavori
+ * vengono eseguiti in sequenza, con lo stesso risultato.
+ * @param num_workers Numero di thread di lavoro (almeno 1).
+ * @param job La funzione da eseguire.
+ * @param context Dati condivisi passati a ogni thread.
+ */
+void run_parallel(int num_workers, lavoro_parallelo job, void *context);
+
+/**
+ * @brief Esegue 'num_tasks' compiti su 'num_workers' thread con distribuzione dinamica: ogni thread prende
+ * il prossimo compito libero appena finisce il precedente, cosi' compiti di durata diversa restano bilanciati.
+ * I compiti vengono assegnati in ordine crescente di indice.
+ * @param num_workers Numero di thread di lavoro (almeno 1).
+ * @param num_tasks Numero di compiti.
+ * @param task La funzione da eseguire per ciascun compito.
+ * @param context Dati condivisi passati a ogni compito.
+ */
+void run_parallel_tasks(int num_workers, int num_tasks, compito_parallelo task, void *context);
+
+#endif /* __parallelo_h */
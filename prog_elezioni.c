@@ -1,3 +1,8 @@
+/* sleep() non e' visibile compilando in modalita' C89 stretta senza questa macro */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 /* classic libraries */
 #include <stdio.h>
 #include <stdlib.h>
@@ -6,11 +11,50 @@
 #include "data_manager.h"
 #include "sort.h"
 #include "metodi.h"
+#include "parallelo.h"
 /* Doxygen++; :) */
 
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#include <unistd.h>
+#define PE_USA_SLEEP 1
+#else
+#include <time.h>
+#define PE_USA_SLEEP 0
+#endif
+
+
+/* Opzioni di esecuzione lette dalla linea di comando */
+typedef struct {
+    char input_filepath[ROW_LENGTH]; /* File di input (testuale o binario) */
+    const char *binary_output;       /* -c <file>: converte l'input nel formato binario e termina */
+    int streaming;                   /* -s: solo metodi di votazione, un cittadino alla volta, senza clustering */
+    int num_workers;                 /* -j <n>: thread di lavoro (predefinito: processori disponibili) */
+    int follow_interval;             /* -f <secondi>: segue il file in crescita, 0 se disattivato */
+    int huge_pages;                  /* -H: huge pages per le matrici grandi */
+    int sample_size;                 /* -C <n>: clustering a campionamento con n cittadini per campione, 0 se disattivato */
+    unsigned long seed;              /* -R <seme>: seme del clustering a campionamento */
+    int verbose;                     /* -v: statistiche del clustering su stderr */
+    int sweep_groups;                /* -S <k_max>: clustering greedy da 1 a k_max gruppi con la curva dei costi, 0 se disattivato */
+    const char *sweep_prints;        /* -G <k1,k2,...>: numeri di gruppi di cui stampare i raggruppamenti in -S */
+} OpzioniProgramma;
 
 /* Permette di ricevere nome file di input da linea di comando o durante l'esecuzione */
-void handle_arguments(int argc, char *argv[], char *input_filepath);
+void handle_arguments(int argc, char *argv[], OpzioniProgramma *options);
+
+/* Stampa la sintassi di utilizzo del programma */
+void print_usage(const char *program_name);
+
+/* Esegue i tre metodi di votazione in un'unica passata sul file, senza memorizzare i cittadini */
+void run_streaming_tally(const char *input_filepath);
+
+/* Segue un file a cui vengono aggiunte schede e ristampa i risultati a intervalli regolari */
+void run_follow_tally(const char *input_filepath, int interval_seconds);
+
+/* Marca i numeri di gruppi da stampare nel clustering incrementale */
+char *parse_sweep_prints(const OpzioniProgramma *options, int default_groups);
+
+/* Attende il numero di secondi indicato */
+void wait_seconds(int seconds);
 
 /* programma principale */
 int main(int argc, char *argv[]) {
@@ -18,80 +62,397 @@ int main(int argc, char *argv[]) {
     /* ----------- */
     /* allocazione */
     /* ----------- */
-    char input_filepath[ROW_LENGTH];
+    OpzioniProgramma options;
+    ArchivioCittadini citizens_store;
     cittadino **citizens_data = NULL;
     char **project_names_list = NULL;
     ParametriInput app_params;
     int i;
     /* creazione delle matrici per i metodi di Borda, Condorcet e di calcolo nel clustering */
-    vint *borda_pref_matrix = NULL, *condorcet_comparison_matrix = NULL, *cluster_distance_matrix = NULL;
+    ClassiSchede ballot_classes;
+    Matrice borda_pref_matrix, condorcet_comparison_matrix;
+    DistanzeTriangolari cluster_distances;
+    cittadino **class_ballots = NULL;
+    StatistichePotatura pruning_stats = {0, 0};
 	contatore **method_score_counters = NULL;
 
     /* ------------ */
     /* elaborazione */
     /* ------------ */
-    handle_arguments(argc, argv, input_filepath);
-    fetch_all_data(input_filepath, &app_params, &citizens_data, &project_names_list);
+    handle_arguments(argc, argv, &options);
+    use_huge_pages(options.huge_pages);
+
+    /* modalita' streaming: memoria O(P^2) indipendente dal numero di abitanti */
+    if (options.streaming) {
+        run_streaming_tally(options.input_filepath);
+        return EXIT_SUCCESS;
+    }
+
+    /* modalita' follow: stato residente aggiornato con le sole righe aggiunte al file */
+    if (options.follow_interval > 0) {
+        run_follow_tally(options.input_filepath, options.follow_interval);
+        return EXIT_SUCCESS;
+    }
+
+    fetch_all_data(options.input_filepath, &app_params, &citizens_store, &project_names_list, options.num_workers);
+    citizens_data = citizens_store.elenco;
+
+    /* modalita' conversione: salva il formato binario e termina senza eseguire i metodi */
+    if (options.binary_output) {
+        save_binary_data(options.binary_output, &app_params, &citizens_store, project_names_list);
+        free_all_resources(app_params.num_progetti, project_names_list, &citizens_store, NULL,
+                           NULL, NULL, NULL, NULL);
+        return EXIT_SUCCESS;
+    }
+
+    /* i confronti tra codici fiscali del clustering usano i ranghi dei codici */
+    rank_citizen_codes(&citizens_store);
 
     /* creazione array di puntatori a struct contatori */
     method_score_counters = initialize_counter_array(app_params.num_progetti);
     
-    borda_pref_matrix = allocate_int_matrix(app_params.num_abitanti, app_params.num_progetti);
-    condorcet_comparison_matrix = allocate_int_matrix(app_params.num_progetti, app_params.num_progetti);
-    cluster_distance_matrix = allocate_int_matrix(app_params.num_abitanti, app_params.num_abitanti);
+    /* schede identiche raccolte in classi: i metodi lavorano una volta per classe, con il suo peso */
+    group_ballot_classes(&citizens_store, &ballot_classes);
+
+    allocate_matrix(&borda_pref_matrix, ballot_classes.num_classi, app_params.num_progetti, select_rank_width(app_params.num_progetti));
+    allocate_matrix(&condorcet_comparison_matrix, app_params.num_progetti, app_params.num_progetti, (int)sizeof(int));
+    /* il clustering a campionamento non usa le distanze tra tutte le coppie: budget nullo */
+    allocate_distance_store(&cluster_distances, ballot_classes.num_classi, app_params.num_progetti,
+                            options.sample_size > 0 ? 0 : (size_t)app_params.num_abitanti * DISTANZE_BYTE_PER_ABITANTE);
 
-    /* raccolta dei dati per i tre metodi */
-    for (i = 0; i < app_params.num_abitanti; ++i) {
-        aggregate_plurality_data(*citizens_data[i], method_score_counters);
-        insert_borda_scores(*citizens_data[i], i, borda_pref_matrix, app_params.num_progetti);
-        aggregate_condorcet_data(*citizens_data[i], condorcet_comparison_matrix, app_params.num_progetti);
+    class_ballots = (cittadino **)malloc((ballot_classes.num_classi > 0 ? ballot_classes.num_classi : 1) * sizeof(cittadino *));
+    if (!class_ballots) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per le schede delle classi.\n");
+        exit(EXIT_FAILURE);
     }
 
+    /* raccolta dei dati per i tre metodi, su piu' thread */
+    for (i = 0; i < ballot_classes.num_classi; ++i) {
+        class_ballots[i] = citizens_data[ballot_classes.rappresentante[i]];
+    }
+    aggregate_ballots(class_ballots, ballot_classes.peso, ballot_classes.num_classi, method_score_counters,
+                      &borda_pref_matrix, &condorcet_comparison_matrix, app_params.num_progetti, options.num_workers);
+    free(class_ballots);
+
     /* elaborazione dei dati raccolti e display dei risultati */
     calculate_and_display_plurality(method_score_counters, project_names_list, app_params.num_progetti);
-    calculate_and_display_borda(borda_pref_matrix, method_score_counters, project_names_list, app_params.num_abitanti, app_params.num_progetti);
-    calculate_and_display_condorcet(condorcet_comparison_matrix, method_score_counters, project_names_list, app_params.num_progetti);
-    perform_greedy_clustering(borda_pref_matrix, cluster_distance_matrix, app_params.num_abitanti, app_params.num_progetti, app_params.num_gruppi, citizens_data);
+    calculate_and_display_borda(&borda_pref_matrix, ballot_classes.peso, method_score_counters, project_names_list, ballot_classes.num_classi, app_params.num_progetti);
+    calculate_and_display_condorcet(&condorcet_comparison_matrix, method_score_counters, project_names_list, app_params.num_progetti);
+    if (options.sample_size > 0) {
+        perform_sampled_clustering(&borda_pref_matrix, &ballot_classes, app_params.num_abitanti, app_params.num_progetti, app_params.num_gruppi, citizens_data,
+                                   options.sample_size, options.seed, &pruning_stats);
+    } else if (options.sweep_groups > 0) {
+        char *print_at = parse_sweep_prints(&options, app_params.num_gruppi);
+        long *group_costs = (long *)malloc((options.sweep_groups + 1) * sizeof(long));
+        int reached_groups;
+        if (!group_costs) {
+            fprintf(stderr, "ERRORE: Allocazione fallita per la curva dei costi.\n");
+            exit(EXIT_FAILURE);
+        }
+        reached_groups = perform_greedy_sweep(&borda_pref_matrix, &cluster_distances, &ballot_classes, app_params.num_abitanti, app_params.num_progetti,
+                                              options.sweep_groups, print_at, citizens_data, options.num_workers, group_costs, &pruning_stats);
+        print_cost_curve(group_costs, reached_groups);
+        free(print_at);
+        free(group_costs);
+    } else {
+        perform_greedy_clustering(&borda_pref_matrix, &cluster_distances, &ballot_classes, app_params.num_abitanti, app_params.num_progetti, app_params.num_gruppi, citizens_data,
+                                  options.num_workers, &pruning_stats);
+    }
+    if (options.verbose) {
+        fprintf(stderr, "Clustering: %ld distanze valutate, %ld evitate dalla disuguaglianza triangolare\n",
+                pruning_stats.valutate, pruning_stats.evitate);
+    }
 
     /* ------------------------ */
     /* deallocazione e chiusura */
     /* ------------------------ */
-    free_all_resources(app_params.num_abitanti, app_params.num_progetti, project_names_list, citizens_data,
-                       method_score_counters, borda_pref_matrix, condorcet_comparison_matrix, cluster_distance_matrix);
+    free_all_resources(app_params.num_progetti, project_names_list, &citizens_store, &ballot_classes,
+                       method_score_counters, &borda_pref_matrix, &condorcet_comparison_matrix, &cluster_distances);
     
     return EXIT_SUCCESS;
 }
 
 /**
  * @brief Gestisce gli argomenti da linea di comando o richiede il nome del file di input.
+ * Sintassi: [opzioni] [nome_file_input], vedi print_usage.
  * @param argc Il numero di argomenti da linea di comando.
  * @param argv L'array degli argomenti da linea di comando.
- * @param input_filepath Buffer dove memorizzare il percorso del file.
+ * @param options Struttura dove memorizzare percorso del file e opzioni.
  */
-void handle_arguments(int argc, char *argv[], char *input_filepath) {
-    if (argc != 2) {
+void handle_arguments(int argc, char *argv[], OpzioniProgramma *options) {
+    int i, has_input = 0;
+    options->binary_output = NULL;
+    options->streaming = 0;
+    options->num_workers = available_workers();
+    options->follow_interval = 0;
+    options->huge_pages = 0;
+    options->sample_size = 0;
+    options->seed = 1;
+    options->verbose = 0;
+    options->sweep_groups = 0;
+    options->sweep_prints = NULL;
+    for (i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            options->binary_output = argv[++i];
+        } else if (strcmp(argv[i], "-s") == 0) {
+            options->streaming = 1;
+        } else if (strcmp(argv[i], "-v") == 0) {
+            options->verbose = 1;
+        } else if (strcmp(argv[i], "-H") == 0) {
+            options->huge_pages = 1;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            options->num_workers = atoi(argv[++i]);
+            if (options->num_workers < 1 || options->num_workers > MAX_WORKERS) {
+                fprintf(stderr, "ERRORE: Numero di thread non valido (da 1 a %d).\n", MAX_WORKERS);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "-C") == 0 && i + 1 < argc) {
+            options->sample_size = atoi(argv[++i]);
+            if (options->sample_size < 1 || options->sample_size > CLARA_CAMPIONE_MASSIMO) {
+                fprintf(stderr, "ERRORE: Dimensione del campione non valida (da 1 a %d).\n", CLARA_CAMPIONE_MASSIMO);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+            options->sweep_groups = atoi(argv[++i]);
+            if (options->sweep_groups < 1) {
+                fprintf(stderr, "ERRORE: Numero massimo di gruppi non valido (almeno 1).\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "-G") == 0 && i + 1 < argc) {
+            options->sweep_prints = argv[++i];
+        } else if (strcmp(argv[i], "-R") == 0 && i + 1 < argc) {
+            options->seed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            options->follow_interval = atoi(argv[++i]);
+            if (options->follow_interval < 1) {
+                fprintf(stderr, "ERRORE: Intervallo di aggiornamento non valido (almeno 1 secondo).\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (argv[i][0] == '-' || has_input) {
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        } else {
+            if (strlen(argv[i]) >= ROW_LENGTH) {
+                fprintf(stderr, "ERRORE: Nome del file troppo lungo (massimo %d caratteri).\n", ROW_LENGTH - 1);
+                exit(EXIT_FAILURE);
+            }
+            /*
+             * Copia il nome del file dall'argomento della riga di comando,
+             * dopo averne verificato la lunghezza rispetto al buffer.
+             */
+            strcpy(options->input_filepath, argv[i]);
+            has_input = 1;
+        }
+    }
+    if (options->streaming && (options->binary_output || options->sample_size || options->sweep_groups || options->sweep_prints)) {
+        fprintf(stderr, "ERRORE: L'opzione -s non e' compatibile con -c, -C, -S e -G.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->follow_interval && (options->streaming || options->binary_output || options->sample_size || options->sweep_groups || options->sweep_prints)) {
+        fprintf(stderr, "ERRORE: L'opzione -f non e' compatibile con -s, -c, -C, -S e -G.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->sweep_prints && !options->sweep_groups) {
+        fprintf(stderr, "ERRORE: L'opzione -G richiede -S.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options->sweep_groups && options->sample_size) {
+        fprintf(stderr, "ERRORE: Le opzioni -S e -C non sono compatibili.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (!has_input) {
         fprintf(stderr, "Nessun file di input specificato. Inserire il nome del file: ");
         /*
          * Per conformit a C89 e per evitare sistemi troppo complicati, si deve assumere
-         * una dimensione massima di input, ad esempio 255 caratteri + terminatore. POSSIBILE BUFFER OVERFLOW
+         * una dimensione massima di input, ad esempio 255 caratteri + terminatore.
          */
-        if (fgets(input_filepath, 256, stdin) == NULL) { /* Assuming a max length for the filename to fit in a common buffer */
+        if (fgets(options->input_filepath, ROW_LENGTH, stdin) == NULL) {
             fprintf(stderr, "ERRORE: Errore durante la lettura del nome del file.\n");
             exit(EXIT_FAILURE);
         }
-        input_filepath[strcspn(input_filepath, "\n")] = '\0'; /* Rimuove il newline finale */
+        options->input_filepath[strcspn(options->input_filepath, "\n")] = '\0'; /* Rimuove il newline finale */
 
-        if (strlen(input_filepath) == 0) {
+        if (strlen(options->input_filepath) == 0) {
             fprintf(stderr, "ERRORE: Nome del file non valido o vuoto.\n");
-            fprintf(stderr, "Utilizzo: %s [nome_file_input]\n", argv[0]);
+            print_usage(argv[0]);
             exit(EXIT_FAILURE);
         }
-    } else {
-        /*
-         * Copia il nome del file dall'argomento della riga di comando.
-         * Si assume che il buffer input_filepath sia sufficientemente grande
-         * per contenere argv[1].
-         */
-        strcpy(input_filepath, argv[1]);
     }
 }
+
+/**
+ * @brief Marca i numeri di gruppi di cui stampare i raggruppamenti nel clustering incrementale (-S): quelli
+ * elencati con -G, separati da virgole, oppure il numero di gruppi del file se e' entro k_max.
+ * @param options Le opzioni, con sweep_groups e sweep_prints.
+ * @param default_groups Il numero di gruppi indicato nel file di input.
+ * @return Array di sweep_groups + 1 elementi, da liberare: 1 in posizione k se i gruppi con k rappresentanti vanno stampati.
+ */
+char *parse_sweep_prints(const OpzioniProgramma *options, int default_groups) {
+    const char *cursor = options->sweep_prints;
+    char *print_at = (char *)calloc(options->sweep_groups + 1, sizeof(char));
+    if (!print_at) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per le opzioni del clustering.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (!cursor) {
+        if (default_groups >= 1 && default_groups <= options->sweep_groups) {
+            print_at[default_groups] = 1;
+        }
+        return print_at;
+    }
+    for (;;) {
+        char *end;
+        long groups = strtol(cursor, &end, 10);
+        if (end == cursor || groups < 1 || groups > options->sweep_groups || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "ERRORE: Elenco di gruppi non valido in -G (numeri da 1 a %d separati da virgole).\n", options->sweep_groups);
+            exit(EXIT_FAILURE);
+        }
+        print_at[groups] = 1;
+        if (*end == '\0') {
+            break;
+        }
+        cursor = end + 1;
+    }
+    return print_at;
+}
+
+/**
+ * @brief Stampa la sintassi di utilizzo del programma.
+ * @param program_name Il nome con cui e' stato invocato il programma.
+ */
+void print_usage(const char *program_name) {
+    fprintf(stderr, "Utilizzo: %s [opzioni] [nome_file_input]\n", program_name);
+    fprintf(stderr, "  -c file_binario  converte l'input nel formato binario compatto e termina\n");
+    fprintf(stderr, "  -C n             clustering a campionamento (CLARA/CLARANS) con n cittadini per campione\n");
+    fprintf(stderr, "  -G k1,k2,...     con -S, stampa i gruppi solo per questi k (predefinito: k del file)\n");
+    fprintf(stderr, "  -f secondi       segue il file mentre vengono aggiunte schede, aggiornando i risultati\n");
+    fprintf(stderr, "  -H               usa le huge pages (THP) per le matrici grandi, dove disponibili\n");
+    fprintf(stderr, "  -j n             usa n thread di lavoro (predefinito: processori disponibili)\n");
+    fprintf(stderr, "  -R seme          seme del clustering a campionamento (predefinito: 1)\n");
+    fprintf(stderr, "  -S k_max         clustering greedy da 1 a k_max gruppi in un'unica esecuzione, con la curva dei costi\n");
+    fprintf(stderr, "  -s               solo Pluralita', Borda e Condorcet in un'unica passata (niente clustering)\n");
+    fprintf(stderr, "  -v               stampa su stderr le distanze valutate ed evitate dal clustering\n");
+    fprintf(stderr, "Opzioni incompatibili: -s e -f tra loro e con -c, -C, -S, -G; -S con -C. -G richiede -S.\n");
+}
+
+/**
+ * @brief Esegue Pluralita', Borda e Condorcet leggendo un cittadino alla volta.
+ * Ogni scheda viene sommata ai contatori, ai totali Borda e alla matrice di Condorcet appena letta:
+ * non servono ne' l'array dei cittadini ne' la matrice Borda per cittadino.
+ * @param input_filepath Il file di input (testuale o binario).
+ */
+void run_streaming_tally(const char *input_filepath) {
+    ParametriInput app_params;
+    char **project_names_list = NULL;
+    contatore **method_score_counters = NULL;
+    vint borda_totals = NULL;
+    Matrice condorcet_comparison_matrix;
+    cittadino *citizen;
+    FlussoCittadini *stream = open_citizen_stream(input_filepath, &app_params, &project_names_list);
+
+    method_score_counters = initialize_counter_array(app_params.num_progetti);
+    allocate_matrix(&condorcet_comparison_matrix, app_params.num_progetti, app_params.num_progetti, (int)sizeof(int));
+    borda_totals = (vint)calloc(app_params.num_progetti, sizeof(int));
+    if (!borda_totals) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per i totali di Borda.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    while ((citizen = read_next_citizen(stream)) != NULL) {
+        aggregate_plurality_data(*citizen, method_score_counters, 1, app_params.num_progetti);
+        accumulate_borda_scores(*citizen, borda_totals, app_params.num_progetti);
+        aggregate_condorcet_data(*citizen, &condorcet_comparison_matrix, app_params.num_progetti, 1);
+    }
+    close_citizen_stream(stream);
+
+    calculate_and_display_plurality(method_score_counters, project_names_list, app_params.num_progetti);
+    calculate_and_display_borda_totals(borda_totals, method_score_counters, project_names_list, app_params.num_progetti);
+    calculate_and_display_condorcet(&condorcet_comparison_matrix, method_score_counters, project_names_list, app_params.num_progetti);
+
+    free(borda_totals);
+    free_all_resources(app_params.num_progetti, project_names_list, NULL, NULL,
+                       method_score_counters, NULL, &condorcet_comparison_matrix, NULL);
+}
+
+/**
+ * @brief Segue un file testuale a cui vengono aggiunte schede durante lo spoglio.
+ * Contatori di pluralita', totali Borda e matrice di Condorcet restano in memoria: a ogni intervallo
+ * vengono lette solo le righe nuove e, se ce ne sono, i risultati vengono ristampati. Termina quando
+ * sono stati letti tutti i cittadini dichiarati nell'intestazione (il clustering non viene eseguito).
+ * @param input_filepath Il file di input (testuale).
+ * @param interval_seconds Secondi tra un controllo e il successivo.
+ */
+void run_follow_tally(const char *input_filepath, int interval_seconds) {
+    ParametriInput app_params;
+    char **project_names_list = NULL;
+    contatore **plurality_tally = NULL, **method_score_counters = NULL;
+    vint borda_totals = NULL;
+    Matrice condorcet_comparison_matrix;
+    cittadino *citizen;
+    CodaCittadini *tail;
+    int j, new_citizens;
+
+    while ((tail = open_citizen_tail(input_filepath, &app_params, &project_names_list)) == NULL) {
+        wait_seconds(interval_seconds); /* Intestazione non ancora completa */
+    }
+
+    /* plurality_tally non viene mai ordinato: le stampe lavorano su una copia in method_score_counters */
+    plurality_tally = initialize_counter_array(app_params.num_progetti);
+    method_score_counters = initialize_counter_array(app_params.num_progetti);
+    allocate_matrix(&condorcet_comparison_matrix, app_params.num_progetti, app_params.num_progetti, (int)sizeof(int));
+    borda_totals = (vint)calloc(app_params.num_progetti, sizeof(int));
+    if (!borda_totals) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per i totali di Borda.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (;;) {
+        new_citizens = 0;
+        while ((citizen = read_appended_citizen(tail)) != NULL) {
+            aggregate_plurality_data(*citizen, plurality_tally, 1, app_params.num_progetti);
+            accumulate_borda_scores(*citizen, borda_totals, app_params.num_progetti);
+            aggregate_condorcet_data(*citizen, &condorcet_comparison_matrix, app_params.num_progetti, 1);
+            new_citizens++;
+        }
+        if (new_citizens > 0) {
+            printf("Aggiornamento: %d cittadini su %d\n\n", citizens_read_from_tail(tail), app_params.num_abitanti);
+            reset_project_counters(method_score_counters, app_params.num_progetti);
+            for (j = 0; j < app_params.num_progetti; ++j) {
+                method_score_counters[j]->cont = plurality_tally[j]->cont;
+            }
+            calculate_and_display_plurality(method_score_counters, project_names_list, app_params.num_progetti);
+            calculate_and_display_borda_totals(borda_totals, method_score_counters, project_names_list, app_params.num_progetti);
+            calculate_and_display_condorcet(&condorcet_comparison_matrix, method_score_counters, project_names_list, app_params.num_progetti);
+            fflush(stdout);
+        }
+        if (citizens_read_from_tail(tail) >= app_params.num_abitanti) {
+            break;
+        }
+        wait_seconds(interval_seconds);
+    }
+    close_citizen_tail(tail);
+
+    free(borda_totals);
+    for (j = 0; j < app_params.num_progetti; ++j) {
+        free(plurality_tally[j]);
+    }
+    free(plurality_tally);
+    free_all_resources(app_params.num_progetti, project_names_list, NULL, NULL,
+                       method_score_counters, NULL, &condorcet_comparison_matrix, NULL);
+}
+
+/**
+ * @brief Attende il numero di secondi indicato.
+ * Dove sleep() non e' disponibile si attende controllando l'orologio di sistema.
+ * @param seconds I secondi di attesa.
+ */
+void wait_seconds(int seconds) {
+#if PE_USA_SLEEP
+    sleep((unsigned int)seconds);
+#else
+    time_t start = time(NULL);
+    while (difftime(time(NULL), start) < (double)seconds) {
+        /* attesa attiva */
+    }
+#endif
+}
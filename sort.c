@@ -1,195 +1,349 @@
 #include "data_manager.h"  /* Include le definizioni delle struct */
 #include "sort.h"          /* Include i prototipi delle funzioni di ordinamento */
 
+static void swap_pointers(void **items, int i, int j);
+static void insertion_sort_pointers(void **items, int low, int high, precede_puntatore precedes, const void *context);
+static void heapsort_pointers(void **items, int low, int high, precede_puntatore precedes, const void *context);
+static void introsort_range(void **items, int low, int high, int depth_limit, precede_puntatore precedes, const void *context);
+static int precedes_alphabetical(const void *first, const void *second, const void *context);
+static int precedes_counter(const void *first, const void *second, const void *context);
+static int precedes_component(const void *first, const void *second, const void *context);
+static int precedes_cluster_component(const void *first, const void *second, const void *context);
+static unsigned long counter_radix_digit(const contatore *counter, int pass);
 
-/* === Funzioni di Quicksort === */			/* Doxygen++; :) */
+
+/* === Funzioni di Ordinamento === */			/* Doxygen++; :) */
 /**
- * @brief Implementazione del quicksort per ordinare le componenti del clustering.
+ * @brief Ordina le componenti del clustering per rappresentante, distanza nulla e codice (vedi sort.h).
  * @param components Array di puntatori a componente.
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
  * @param citizens_data Array di strutture cittadino (per confronto dei codici).
  */
 void qsort_clustering(componente **components, int low, int high, cittadino **citizens_data) {
-    if (low < high) {
-        int pivot_pos = partition_cluster_components(components, low, high, citizens_data);
-        qsort_clustering(components, low, pivot_pos - 1, citizens_data);
-        qsort_clustering(components, pivot_pos + 1, high, citizens_data);
-    }
+    introsort_pointers((void **)components, low, high, precedes_cluster_component, (const void *)citizens_data);
 }
 /**
- * @brief Implementazione del quicksort per ordinare alfabeticamente un array di nomi di progetti.
+ * @brief Ordina alfabeticamente un array di nomi di progetti.
  * @param project_names Array di puntatori a stringa (nomi di progetto).
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
  */
 void qsort_alfabetico(char **project_names, int low, int high) {
-    if (low < high) {
-        int pivot_pos = partition_alphabetical(project_names, low, high);
-        qsort_alfabetico(project_names, low, pivot_pos - 1);
-        qsort_alfabetico(project_names, pivot_pos + 1, high);
-    }
+    introsort_pointers((void **)project_names, low, high, precedes_alphabetical, NULL);
 }
 /**
- * @brief Implementazione del quicksort per ordinare un array di contatori.
- * L'ordinamento  primariamente numerico (decrescente o crescente) e secondariamente per indice (crescente).
+ * @brief Ordina un array di contatori per 'cont' decrescente e 'indice' crescente, con un radix sort LSD.
  * @param counters Array di puntatori a contatore.
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
  * @param order Indica il tipo di ordinamento (0 per decrescente cont, crescente indice).
  */
 void qsort_punt_lescg(contatore **counters, int low, int high, int order) {
-    if (low < high) {
-        int pivot_pos = partition_numerical_alphabetical(counters, low, high, order);
-        qsort_punt_lescg(counters, low, pivot_pos - 1, order);
-        qsort_punt_lescg(counters, pivot_pos + 1, high, order);
+    /** Si assume che 'order' sia 0 per ordinamento decrescente sul contatore e crescente sull'indice
+     *	L'implementazione originale gestiva solo 'ord == 0' e un 'if' commentato per 'ord == 1'.
+     *  Mantengo il comportamento originale (decrescente cont, crescente indice).
+     */
+    int count = high - low + 1;
+    int pass, i, first_pass = 0;
+    contatore **from = counters + low, **to, **buffer;
+    (void)order;
+    if (count < SORT_SOGLIA_RADIX) {
+        insertion_sort_pointers((void **)counters, low, high, precedes_counter, NULL);
+        return;
+    }
+    buffer = (contatore **)malloc(count * sizeof(contatore *));
+    if (!buffer) {
+        fprintf(stderr, "ERRORE: Allocazione fallita per l'ordinamento dei contatori.\n");
+        exit(EXIT_FAILURE);
+    }
+    /* Indici gia' crescenti: l'ordine secondario c'e' gia', restano le sole passate su cont */
+    for (i = 1; i < count && from[i - 1]->indice < from[i]->indice; ++i) {
     }
+    if (i == count) {
+        first_pass = 4;
+    }
+    to = buffer;
+    /* Passate 0-3: byte dell'indice (crescente); 4-7: byte di cont (decrescente) */
+    for (pass = first_pass; pass < 8; ++pass) {
+        int histogram[256];
+        int digit, position = 0;
+        contatore **swap;
+        memset(histogram, 0, sizeof(histogram));
+        for (i = 0; i < count; ++i) {
+            histogram[counter_radix_digit(from[i], pass)]++;
+        }
+        if (histogram[counter_radix_digit(from[0], pass)] == count) {
+            continue; /* Stesso byte per tutti: la passata non sposterebbe nulla */
+        }
+        for (digit = 0; digit < 256; ++digit) {
+            int bucket = histogram[digit];
+            histogram[digit] = position;
+            position += bucket;
+        }
+        for (i = 0; i < count; ++i) {
+            to[histogram[counter_radix_digit(from[i], pass)]++] = from[i];
+        }
+        swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != counters + low) {
+        memcpy(counters + low, from, count * sizeof(contatore *));
+    }
+    free(buffer);
 }
 /**
- * @brief Implementazione del quicksort per ordinare i contatori in base alle componenti connesse Condorcet.
+ * @brief Ordina i contatori in base alle componenti connesse Condorcet.
  * @param counters Array di puntatori a contatore.
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
  * @param matrix Matrice di Condorcet usata per i confronti tra componenti.
  */
-void qsort_componenti(contatore **counters, int low, int high, vint *matrix) {
+void qsort_componenti(contatore **counters, int low, int high, const Matrice *matrix) {
+    introsort_pointers((void **)counters, low, high, precedes_component, (const void *)matrix);
+}
+
+/**
+ * @brief Introsort su un array di puntatori (vedi sort.h).
+ * @param items Array di puntatori.
+ * @param low Indice del primo elemento.
+ * @param high Indice dell'ultimo elemento.
+ * @param precedes Ordine stretto tra gli elementi.
+ * @param context Dato passato a precedes.
+ */
+void introsort_pointers(void **items, int low, int high, precede_puntatore precedes, const void *context) {
+    int depth_limit = 0, length;
+    for (length = high - low + 1; length > 1; length >>= 1) {
+        depth_limit += 2; /* 2 * log2(n) livelli prima di passare a heapsort */
+    }
     if (low < high) {
-        int pivot_pos = partition_components(counters, low, high, matrix);
-        qsort_componenti(counters, low, pivot_pos - 1, matrix);
-        qsort_componenti(counters, pivot_pos + 1, high, matrix);
+        introsort_range(items, low, high, depth_limit, precedes, context);
     }
 }
 
-
-/* === Funzioni di Partizione === */
-
 /**
- * @brief Funzione di partizione per il quicksort di contatori Condorcet.
- * Ordina per appartenenza alla componente connessa e poi lessicograficamente.
- * @param counters Array di puntatori a contatore.
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @param matrix Matrice di Condorcet usata per i confronti tra componenti.
- * @return La posizione finale del pivot.
+ * @brief Un livello di introsort: partiziona attorno al mediano di tre, ricorre sulla parte minore e
+ * prosegue sulla maggiore, finche' il sotto-array non e' abbastanza piccolo per l'inserzione.
+ * @param items Array di puntatori.
+ * @param low Indice del primo elemento.
+ * @param high Indice dell'ultimo elemento.
+ * @param depth_limit Livelli rimasti prima di passare a heapsort.
+ * @param precedes Ordine stretto tra gli elementi.
+ * @param context Dato passato a precedes.
  */
-int partition_components(contatore **counters, int low, int high, vint *matrix) {
-    int pivot_idx = low,i;
-    for (i = low + 1; i <= high; ++i) {
-        /* Stessa componente connessa (stesso valore 'cont'), ordina per indice (alfabeticamente implicito) */
-        if (counters[i]->cont == counters[low]->cont) {
-            if (counters[i]->indice < counters[low]->indice) {
-                pivot_idx++;
-                swap_counters(counters, i, pivot_idx);
+static void introsort_range(void **items, int low, int high, int depth_limit, precede_puntatore precedes, const void *context) {
+    while (high - low + 1 > SORT_SOGLIA_INSERZIONE) {
+        int middle = low + (high - low) / 2;
+        int i, j;
+        void *pivot;
+        if (depth_limit-- == 0) {
+            heapsort_pointers(items, low, high, precedes, context);
+            return;
+        }
+        /* Mediano di tre in items[low]: niente caso peggiore su dati ordinati o rovesciati */
+        if (precedes(items[middle], items[low], context)) {
+            swap_pointers(items, middle, low);
+        }
+        if (precedes(items[high], items[middle], context)) {
+            swap_pointers(items, high, middle);
+            if (precedes(items[middle], items[low], context)) {
+                swap_pointers(items, middle, low);
             }
         }
-        /* Componenti diverse, ordina in base alla relazione nella matrice Condorcet */
-        else {
-            /* Se i vince su s (pivot), lo si mette prima */
-            if (matrix[counters[i]->indice][counters[low]->indice] > matrix[counters[low]->indice][counters[i]->indice]) {
-                pivot_idx++;
-                swap_counters(counters, i, pivot_idx);
+        swap_pointers(items, low, middle);
+        pivot = items[low];
+        /* Partizione di Hoare: entrambi gli indici si fermano sugli uguali al pivot, che si dividono a meta' */
+        i = low;
+        j = high + 1;
+        for (;;) {
+            do {
+                ++i;
+            } while (i <= high && precedes(items[i], pivot, context));
+            do {
+                --j;
+            } while (precedes(pivot, items[j], context));
+            if (i >= j) {
+                break;
             }
+            swap_pointers(items, i, j);
+        }
+        swap_pointers(items, low, j);
+        if (j - low < high - j) {
+            introsort_range(items, low, j - 1, depth_limit, precedes, context);
+            low = j + 1;
+        } else {
+            introsort_range(items, j + 1, high, depth_limit, precedes, context);
+            high = j - 1;
         }
     }
-    swap_counters(counters, low, pivot_idx);
-    return pivot_idx;
+    insertion_sort_pointers(items, low, high, precedes, context);
 }
 
-
-
 /**
- * @brief Funzione di partizione per il quicksort delle componenti del clustering.
- * Ordina per rappresentante del cluster (alfabeticamente) e poi per distanza minima.
- * @param components Array di puntatori a componente.
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @param citizens_data Array di strutture cittadino (per confronto dei codici).
- * @return La posizione finale del pivot.
+ * @brief Ordinamento per inserzione, per i sotto-array piccoli.
+ * @param items Array di puntatori.
+ * @param low Indice del primo elemento.
+ * @param high Indice dell'ultimo elemento.
+ * @param precedes Ordine stretto tra gli elementi.
+ * @param context Dato passato a precedes.
  */
-int partition_cluster_components(componente **components, int low, int high, cittadino **citizens_data) {
-    int pivot_idx = low,i;
+static void insertion_sort_pointers(void **items, int low, int high, precede_puntatore precedes, const void *context) {
+    int i, j;
     for (i = low + 1; i <= high; ++i) {
-        /* Se hanno lo stesso rappresentante */
-        if (components[i]->rappr == components[low]->rappr) {
-            /* Ordina prima il rappresentante (distanza min = 0), se il pivot non lo  */
-            if (components[i]->min == 0) { /* Questo elemento  un rappresentante */
-                pivot_idx++;
-                swap_components(components, i, pivot_idx);
-            }
-            /* Se entrambi non sono rappresentanti o entrambi lo sono, ordina per codice cittadino */
-            else if (strcmp(citizens_data[components[i]->ind]->CF, citizens_data[components[low]->ind]->CF) < 0) {
-                pivot_idx++;
-                swap_components(components, i, pivot_idx);
-            }
-        }
-        /* Se hanno rappresentanti diversi, ordina per codice del rappresentante (alfabeticamente) */
-        else {
-            if (strcmp(citizens_data[components[i]->rappr]->CF, citizens_data[components[low]->rappr]->CF) < 0) {
-                pivot_idx++;
-                swap_components(components, i, pivot_idx);
-            }
+        void *moving = items[i];
+        for (j = i; j > low && precedes(moving, items[j - 1], context); --j) {
+            items[j] = items[j - 1];
         }
+        items[j] = moving;
     }
-    swap_components(components, low, pivot_idx);
-    return pivot_idx;
 }
+
 /**
- * @brief Funzione di partizione per il quicksort di contatori.
- * Ordina in base al campo 'cont' (decrescente) e poi 'indice' (crescente).
- * @param counters Array di puntatori a contatore.
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @param order Indica il tipo di ordinamento (0 per decrescente cont, crescente indice).
- * @return La posizione finale del pivot.
+ * @brief Heapsort, per i sotto-array su cui il quicksort ha superato il limite di profondita'.
+ * @param items Array di puntatori.
+ * @param low Indice del primo elemento.
+ * @param high Indice dell'ultimo elemento.
+ * @param precedes Ordine stretto tra gli elementi.
+ * @param context Dato passato a precedes.
  */
-int partition_numerical_alphabetical(contatore **counters, int low, int high, int order) {
-    int pivot_idx = low, i;
-    /** Si assume che 'order' sia 0 per ordinamento decrescente sul contatore e crescente sull'indice
-     *	L'implementazione originale gestiva solo 'ord == 0' e un 'if' commentato per 'ord == 1'.
-     *  Mantengo il comportamento originale (decrescente cont, crescente indice).
-     */
-    for (i = low + 1; i <= high; ++i) {
-        /* Ordine decrescente per 'cont' */
-        if (counters[i]->cont > counters[low]->cont) {
-            pivot_idx++;
-            swap_counters(counters, i, pivot_idx);
+static void heapsort_pointers(void **items, int low, int high, precede_puntatore precedes, const void *context) {
+    void **heap = items + low;
+    int count = high - low + 1;
+    int start, end;
+    /* Heap con il massimo in cima, costruito dal basso; poi il massimo va in fondo a ogni passo */
+    for (start = count / 2 - 1, end = count; end > 1; ) {
+        int root, child;
+        void *moving;
+        if (start >= 0) {
+            root = start--;
+        } else {
+            end--;
+            moving = heap[end];
+            heap[end] = heap[0];
+            heap[0] = moving;
+            root = 0;
         }
-        /* In caso di parit di 'cont', ordina per 'indice' (crescente) */
-        else if (counters[i]->cont == counters[low]->cont) {
-            if (counters[i]->indice < counters[low]->indice) {
-                pivot_idx++;
-                swap_counters(counters, i, pivot_idx);
+        moving = heap[root];
+        while ((child = 2 * root + 1) < end) {
+            if (child + 1 < end && precedes(heap[child], heap[child + 1], context)) {
+                child++;
             }
+            if (!precedes(moving, heap[child], context)) {
+                break;
+            }
+            heap[root] = heap[child];
+            root = child;
         }
+        heap[root] = moving;
     }
-    swap_counters(counters, low, pivot_idx);
-    return pivot_idx;
+}
+
+
+/* === Ordini tra gli elementi === */
+
+/**
+ * @brief Ordine alfabetico tra nomi di progetto.
+ * @param first Il primo nome.
+ * @param second Il secondo nome.
+ * @param context Non usato.
+ * @return 1 se first precede second.
+ */
+static int precedes_alphabetical(const void *first, const void *second, const void *context) {
+    (void)context;
+    return strcmp((const char *)first, (const char *)second) < 0;
 }
 
 /**
- * @brief Funzione di partizione per il quicksort alfabetico di stringhe.
- * @param project_names Array di puntatori a stringa (nomi di progetto).
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @return La posizione finale del pivot.
+ * @brief Ordine dei contatori: 'cont' decrescente, poi 'indice' crescente.
+ * @param first Il primo contatore.
+ * @param second Il secondo contatore.
+ * @param context Non usato.
+ * @return 1 se first precede second.
  */
-int partition_alphabetical(char **project_names, int low, int high) {
-    int pivot_idx = low, i; /* Sceglie il primo elemento come pivot */
-    for (i = low + 1; i <= high; ++i) {
-        /* Ordine crescente alfabeticamente */
-        if (strcmp(project_names[i], project_names[low]) < 0) {
-            pivot_idx++;
-            swap_string_pointers(&project_names[i], &project_names[pivot_idx]);
-        }
+static int precedes_counter(const void *first, const void *second, const void *context) {
+    const contatore *a = (const contatore *)first, *b = (const contatore *)second;
+    (void)context;
+    return a->cont > b->cont || (a->cont == b->cont && a->indice < b->indice);
+}
+
+/**
+ * @brief Byte di una passata del radix sort dei contatori. Le passate 0-3 leggono l'indice (non negativo,
+ * crescente); le 4-7 leggono cont con il bit di segno invertito (cosi' i negativi precedono come interi senza
+ * segno) e complementato, per l'ordine decrescente.
+ * @param counter Il contatore.
+ * @param pass La passata, da 0 a 7.
+ * @return Il byte, da 0 a 255.
+ */
+static unsigned long counter_radix_digit(const contatore *counter, int pass) {
+    unsigned long key;
+    if (pass < 4) {
+        key = (unsigned long)counter->indice;
+    } else {
+        key = ~((unsigned long)counter->cont ^ 0x80000000UL);
+        pass -= 4;
     }
-    swap_string_pointers(&project_names[low], &project_names[pivot_idx]);
-    return pivot_idx;
+    return (key >> (8 * pass)) & 0xFFUL;
 }
 
+/**
+ * @brief Ordine dei contatori Condorcet: stessa componente connessa (stesso 'cont') per indice crescente,
+ * componenti diverse secondo chi vince nella matrice di Condorcet.
+ * @param first Il primo contatore.
+ * @param second Il secondo contatore.
+ * @param context La matrice di Condorcet.
+ * @return 1 se first precede second.
+ */
+static int precedes_component(const void *first, const void *second, const void *context) {
+    const contatore *a = (const contatore *)first, *b = (const contatore *)second;
+    const Matrice *matrix = (const Matrice *)context;
+    if (a->cont == b->cont) {
+        return a->indice < b->indice;
+    }
+    /* Se a vince su b, lo si mette prima */
+    return MATRICE_INT(matrix, a->indice)[b->indice] > MATRICE_INT(matrix, b->indice)[a->indice];
+}
 
-/* === Funzioni di Ausiliarie - Swap === */
+/**
+ * @brief Ordine delle componenti del clustering (vedi qsort_clustering in sort.h).
+ * @param first La prima componente.
+ * @param second La seconda componente.
+ * @param context Array di strutture cittadino.
+ * @return 1 se first precede second.
+ */
+static int precedes_cluster_component(const void *first, const void *second, const void *context) {
+    const componente *a = (const componente *)first, *b = (const componente *)second;
+    cittadino *const *citizens_data = (cittadino *const *)context;
+    /* Rappresentanti diversi: per codice del rappresentante (alfabeticamente) */
+    if (a->rappr != b->rappr) {
+        int a_rank = citizens_data[a->rappr]->rango_cf, b_rank = citizens_data[b->rappr]->rango_cf;
+        return a_rank < b_rank || (a_rank == b_rank && a->rappr < b->rappr);
+    }
+    /* Stesso rappresentante: prima chi e' a distanza 0 (il rappresentante e le schede uguali alla sua) */
+    if ((a->min == 0) != (b->min == 0)) {
+        return a->min == 0;
+    }
+    /* Poi per codice cittadino */
+    if (citizens_data[a->ind]->rango_cf != citizens_data[b->ind]->rango_cf) {
+        return citizens_data[a->ind]->rango_cf < citizens_data[b->ind]->rango_cf;
+    }
+    return a->ind < b->ind;
+}
 
 
+/* === Funzioni di Ausiliarie - Swap === */
+
+/**
+ * @brief Scambia due elementi di un array di puntatori generici.
+ * @param items Array di puntatori.
+ * @param i Indice del primo elemento da scambiare.
+ * @param j Indice del secondo elemento da scambiare.
+ */
+static void swap_pointers(void **items, int i, int j) {
+    void *temp = items[i];
+    items[i] = items[j];
+    items[j] = temp;
+}
 /**
  * @brief Scambia due puntatori a stringa (nomi di progetto).
  * @param a Puntatore al primo puntatore a stringa.
@@ -222,4 +376,3 @@ void swap_counters(contatore **counters, int i, int j) { /* l'ho preferito a pas
     counters[i] = counters[j];
     counters[j] = temp;
 }
-
@@ -7,22 +7,43 @@
 
 #include "data_manager.h" /* Include la definizione delle struct e costanti*/ /* Doxygen++; :) */
 
+/* Sotto-array di al piu' tanti elementi si ordinano per inserzione */
+#ifndef SORT_SOGLIA_INSERZIONE
+#define SORT_SOGLIA_INSERZIONE 16
+#endif
 
+/* Array di contatori sotto questa lunghezza si ordinano per inserzione invece che con il radix sort */
+#ifndef SORT_SOGLIA_RADIX
+#define SORT_SOGLIA_RADIX 64
+#endif
+
+/**
+ * Ordine stretto tra due elementi di un array di puntatori: diverso da 0 se first va prima di second.
+ * context e' il dato aggiuntivo passato all'ordinamento (matrice, cittadini, ...), o NULL.
+ */
+typedef int (*precede_puntatore)(const void *first, const void *second, const void *context);
 
-/* === Funzioni di Quicksort per Nomi di Progetto (alfabetico) === */
 
+/* === Ordinamento generico (introsort) === */
 
 /**
- * @brief Funzione di partizione per il quicksort alfabetico di stringhe.
- * @param project_names Array di puntatori a stringa (nomi di progetto).
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @return La posizione finale del pivot.
+ * @brief Introsort su un array di puntatori: quicksort con pivot mediano di tre, ricorsione solo sulla parte
+ * minore (profondita' dello stack O(log n)), heapsort oltre 2*log2(n) livelli e inserzione sui sotto-array
+ * piccoli. O(n log n) nel caso peggiore, anche su dati gia' ordinati o con molte parita'.
+ * L'ordinamento non e' stabile: precedes deve essere un ordine totale perche' il risultato sia univoco.
+ * @param items Array di puntatori.
+ * @param low Indice del primo elemento.
+ * @param high Indice dell'ultimo elemento.
+ * @param precedes Ordine stretto tra gli elementi.
+ * @param context Dato passato a precedes.
  */
-int partition_alphabetical(char **project_names, int low, int high);
+void introsort_pointers(void **items, int low, int high, precede_puntatore precedes, const void *context);
+
+
+/* === Ordinamento per Nomi di Progetto (alfabetico) === */
 
 /**
- * @brief Implementazione del quicksort per ordinare alfabeticamente un array di nomi di progetti.
+ * @brief Ordina alfabeticamente un array di nomi di progetti (introsort).
  * @param project_names Array di puntatori a stringa (nomi di progetto).
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
@@ -30,51 +51,51 @@ int partition_alphabetical(char **project_names, int low, int high);
 void qsort_alfabetico(char **project_names, int low, int high);
 
 
-/* === Funzioni di Quicksort per Contatori (numerico e alfabetico) === */
+/* === Ordinamento per Contatori (numerico e alfabetico) === */
 
 /**
- * @brief Funzione di partizione per il quicksort di contatori.
- * Ordina in base al campo 'cont' (decrescente) e poi 'indice' (crescente).
+ * @brief Ordina un array di contatori per 'cont' decrescente e, a parita', 'indice' crescente.
+ * Radix sort LSD a byte sulla chiave (cont decrescente, indice crescente): passate stabili prima sui byte
+ * dell'indice, poi su quelli di cont; le passate in cui tutti gli elementi hanno lo stesso byte si saltano,
+ * e quelle sull'indice anche quando gli indici sono gia' crescenti (come dopo reset_project_counters).
+ * Sotto SORT_SOGLIA_RADIX elementi si ordina per inserzione.
  * @param counters Array di puntatori a contatore.
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
- * @param order Indica il tipo di ordinamento (0 per decrescente cont, crescente indice).
- * @return La posizione finale del pivot.
- */
-int partition_numerical_alphabetical(contatore **counters, int low, int high, int order);
-
-/**
- * @brief Implementazione del quicksort per ordinare un array di contatori.
- * L'ordinamento  primariamente numerico (decrescente o crescente) e secondariamente per indice (crescente).
- * @param counters Array di puntatori a contatore.
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @param order Indica il tipo di ordinamento (0 per decrescente cont, crescente indice).
+ * @param order Indica il tipo di ordinamento (0 per decrescente cont, crescente indice; l'unico supportato).
  */
 void qsort_punt_lescg(contatore **counters, int low, int high, int order);
 
 /**
- * @brief Funzione di partizione per il quicksort di contatori Condorcet.
- * Ordina per appartenenza alla componente connessa e poi lessicograficamente.
+ * @brief Ordina i contatori in base alle componenti connesse Condorcet (introsort).
+ * Contatori della stessa componente (stesso 'cont') per indice crescente; di componenti diverse secondo la
+ * matrice di Condorcet: tra componenti fortemente connesse diverse ogni confronto ha un vincitore stretto
+ * e tutti vanno nello stesso verso, quindi l'ordine e' totale.
  * @param counters Array di puntatori a contatore.
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
  * @param matrix Matrice di Condorcet usata per i confronti tra componenti.
- * @return La posizione finale del pivot.
  */
-int partition_components(contatore **counters, int low, int high, vint *matrix);
+void qsort_componenti(contatore **counters, int low, int high, const Matrice *matrix);
+
+
+/* === Ordinamento per Componenti del Clustering === */
 
 /**
- * @brief Implementazione del quicksort per ordinare i contatori in base alle componenti connesse Condorcet.
- * @param counters Array di puntatori a contatore.
+ * @brief Ordina le componenti del clustering (introsort) per la stampa dei gruppi, secondo l'ordine totale:
+ * - codice del rappresentante crescente (e, tra rappresentanti con lo stesso codice, indice crescente),
+ *   cosi' che ogni gruppo sia contiguo;
+ * - nel gruppo, prima i cittadini a distanza 0 dal rappresentante (lui compreso), poi gli altri;
+ * - a parita', codice del cittadino crescente, poi indice crescente.
+ * @param components Array di puntatori a componente.
  * @param low Indice di inizio della sotto-array.
  * @param high Indice di fine della sotto-array.
- * @param matrix Matrice di Condorcet usata per i confronti tra componenti.
+ * @param citizens_data Array di strutture cittadino (per confronto dei codici, tramite rango_cf).
  */
-void qsort_componenti(contatore **counters, int low, int high, vint *matrix);
+void qsort_clustering(componente **components, int low, int high, cittadino **citizens_data);
 
 
-/* === Funzioni di Quicksort per Componenti del Clustering === */
+/* === Funzioni Ausiliarie - Swap === */
 
 /**
  * @brief Scambia due puntatori a strutture 'componente'.
@@ -98,25 +119,4 @@ void swap_string_pointers(char **a, char **b);
  */
 void swap_counters(contatore **counters, int i, int j);
 
-/**
- * @brief Funzione di partizione per il quicksort delle componenti del clustering.
- * Ordina per rappresentante del cluster (alfabeticamente) e poi per distanza minima.
- * @param components Array di puntatori a componente.
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @param citizens_data Array di strutture cittadino (per confronto dei codici).
- * @return La posizione finale del pivot.
- */
- 
-int partition_cluster_components(componente **components, int low, int high, cittadino **citizens_data);
-
-/**
- * @brief Implementazione del quicksort per ordinare le componenti del clustering.
- * @param components Array di puntatori a componente.
- * @param low Indice di inizio della sotto-array.
- * @param high Indice di fine della sotto-array.
- * @param citizens_data Array di strutture cittadino (per confronto dei codici).
- */
-void qsort_clustering(componente **components, int low, int high, cittadino **citizens_data);
-
 #endif /* __sort_h */
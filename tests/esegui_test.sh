@@ -0,0 +1,65 @@
+#!/bin/sh
+#
+# Test di regressione: esegue tests/test_listaarchi.c, poi compila il programma e confronta l'output di
+# ogni tests/*.txt (messaggi di errore compresi) con il corrispondente tests/*.atteso, leggendo il file
+# con un thread e con piu' thread, e in modalita' -s per la sola sezione dei metodi.
+# Il programma e' compilato con blocchi del parser piccoli, cosi' che anche i file di prova vengano
+# divisi tra i thread.
+#
+# Utilizzo, dalla cartella principale del progetto:
+#   sh tests/esegui_test.sh
+# Il compilatore si puo' scegliere con CC (predefinito: gcc).
+
+CC=${CC:-gcc}
+CFLAGS="-std=c89 -pedantic -Wall -O2"
+TEST_DIR=$(dirname "$0")
+BUILD_DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+$CC $CFLAGS -DPARSER_BYTE_PER_THREAD=16 -o "$BUILD_DIR/prog_elezioni" "$TEST_DIR"/../*.c -lm || exit 1
+
+falliti=0
+
+# Liste di archi con il pool a blocchi, anche con un arco per blocco
+for blocco in 256 1; do
+    $CC $CFLAGS -DARCHI_PER_BLOCCO=$blocco -I"$TEST_DIR/.." -o "$BUILD_DIR/test_listaarchi" \
+        "$TEST_DIR/test_listaarchi.c" "$TEST_DIR/../listaarchi.c" || exit 1
+    if "$BUILD_DIR/test_listaarchi" > /dev/null; then
+        echo "ok: test_listaarchi (ARCHI_PER_BLOCCO=$blocco)"
+    else
+        echo "FALLITO: test_listaarchi (ARCHI_PER_BLOCCO=$blocco)"
+        falliti=$((falliti + 1))
+    fi
+done
+
+# confronta NOME FILE_ATTESO OPZIONI...: esegue il programma e confronta stdout e stderr con FILE_ATTESO
+confronta() {
+    nome=$1
+    atteso=$2
+    shift 2
+    "$BUILD_DIR/prog_elezioni" "$@" > "$BUILD_DIR/uscita" 2>&1
+    if cmp -s "$BUILD_DIR/uscita" "$atteso"; then
+        return 0
+    fi
+    echo "FALLITO: $nome ($*)"
+    diff "$atteso" "$BUILD_DIR/uscita" | head -20
+    falliti=$((falliti + 1))
+    return 1
+}
+
+for input in "$TEST_DIR"/*.txt; do
+    atteso="${input%.txt}.atteso"
+    nome=$(basename "$input" .txt)
+    confronta "$nome" "$atteso" -j 1 "$input" || continue
+    confronta "$nome" "$atteso" -j 4 "$input" || continue
+    # -s non esegue il clustering: deve coincidere con la parte dei metodi
+    sed '/^Gruppi/,$d' "$atteso" > "$BUILD_DIR/$nome.metodi"
+    confronta "$nome" "$BUILD_DIR/$nome.metodi" -s "$input" || continue
+    echo "ok: $nome"
+done
+
+if [ "$falliti" -ne 0 ]; then
+    echo "$falliti test falliti"
+    exit 1
+fi
+echo "Tutti i test superati"
@@ -0,0 +1,130 @@
+/*
+ * Test casuale delle liste di archi (listaarchi.h) con il pool a blocchi.
+ * Quattro liste, tre nello stesso pool e una con il pool proprio, subiscono inserimenti e cancellazioni
+ * in posizioni casuali, confrontati con un vettore di riferimento; ogni tanto una lista viene distrutta
+ * e ricreata, cosi' che i suoi archi tornino alla lista dei liberi e vengano riusati dalle altre.
+ *
+ * Compilazione, dalla cartella principale del progetto (ARCHI_PER_BLOCCO piccolo esercita piu' blocchi):
+ *   gcc -std=c89 -pedantic -Wall -O2 -I. -o test_listaarchi tests/test_listaarchi.c listaarchi.c
+ *   gcc -std=c89 -pedantic -Wall -O2 -I. -DARCHI_PER_BLOCCO=1 -o test_listaarchi tests/test_listaarchi.c listaarchi.c
+ * Utilizzo:
+ *   ./test_listaarchi [seme]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "listaarchi.h"
+
+#define NUM_LISTE   4
+#define MAX_ARCHI   2000
+#define ITERAZIONI  300
+#define OPERAZIONI  3000
+
+/* Archi attesi in ogni lista, nell'ordine di scorrimento (la destinazione identifica l'arco) */
+static nodo riferimento[NUM_LISTE][MAX_ARCHI];
+static int lunghezza[NUM_LISTE];
+
+/* L'ultima lista ha il pool proprio, le altre condividono P */
+static listaarchi crea_lista (poolarchi *P, int k)
+{
+  return (k == NUM_LISTE-1) ? crealistaarchi() : crealistaarchipool(P);
+}
+
+/* Posizione dell'arco di indice pos (0 = primo) nella lista L */
+static posarco posizione (listaarchi L, int pos)
+{
+  posarco p = primolistaarchi(L);
+  while (pos-- > 0)
+    p = succlistaarchi(L,p);
+  return p;
+}
+
+/* Confronta la lista k con il riferimento: in avanti, all'indietro e sulla lunghezza */
+static boolean verifica_lista (listaarchi L, int k)
+{
+  posarco p;
+  nodo orig, dest;
+  int i = 0;
+
+  for (p = primolistaarchi(L); !finelistaarchi(L,p); p = succlistaarchi(L,p))
+  {
+    leggearco(L,p,&orig,&dest);
+    if (i >= lunghezza[k] || orig != k || dest != riferimento[k][i])
+      return FALSE;
+    i++;
+  }
+  if (i != lunghezza[k] || listaarchivuota(L) != (lunghezza[k] == 0))
+    return FALSE;
+
+  for (p = ultimolistaarchi(L); !finelistaarchi(L,p); p = preclistaarchi(L,p))
+  {
+    leggearco(L,p,&orig,&dest);
+    if (dest != riferimento[k][--i])
+      return FALSE;
+  }
+  return (i == 0);
+}
+
+int main (int argc, char *argv[])
+{
+  listaarchi L[NUM_LISTE];
+  poolarchi *P;
+  posarco p;
+  int it, op, k, i, pos;
+
+  srand((argc > 1) ? (unsigned) atoi(argv[1]) : 9);
+
+  for (it = 0; it < ITERAZIONI; it++)
+  {
+    P = creapoolarchi();
+    for (k = 0; k < NUM_LISTE; k++)
+    {
+      L[k] = crea_lista(P,k);
+      lunghezza[k] = 0;
+    }
+
+    for (op = 0; op < OPERAZIONI; op++)
+    {
+      k = rand() % NUM_LISTE;
+      if ( (rand() % 3 != 0) && (lunghezza[k] < MAX_ARCHI) )
+      {
+        /* Inserimento prima dell'arco di indice pos (in coda se pos == lunghezza) */
+        pos = rand() % (lunghezza[k]+1);
+        inslistaarchi(L[k],posizione(L[k],pos),k,op);
+        for (i = lunghezza[k]; i > pos; i--)
+          riferimento[k][i] = riferimento[k][i-1];
+        riferimento[k][pos] = op;
+        lunghezza[k]++;
+      }
+      else if (lunghezza[k] > 0)
+      {
+        pos = rand() % lunghezza[k];
+        p = posizione(L[k],pos);
+        canclistaarchi(L[k],&p);
+        for (i = pos; i < lunghezza[k]-1; i++)
+          riferimento[k][i] = riferimento[k][i+1];
+        lunghezza[k]--;
+      }
+
+      if (rand() % 500 == 0)
+      {
+        distruggelistaarchi(&L[k]);
+        L[k] = crea_lista(P,k);
+        lunghezza[k] = 0;
+      }
+    }
+
+    for (k = 0; k < NUM_LISTE; k++)
+      if (!verifica_lista(L[k],k))
+      {
+        fprintf(stderr,"ERRORE: la lista %d non coincide con il riferimento (iterazione %d).\n",k,it);
+        exit(EXIT_FAILURE);
+      }
+
+    for (k = 0; k < NUM_LISTE; k++)
+      distruggelistaarchi(&L[k]);
+    distruggepoolarchi(&P);
+  }
+
+  printf("ok: %d iterazioni da %d operazioni su %d liste\n",ITERAZIONI,OPERAZIONI,NUM_LISTE);
+  return EXIT_SUCCESS;
+}